@@ -0,0 +1,303 @@
+#include "BackdropCache.hpp"
+#include "BlurPasses.hpp"
+#include "Globals.hpp"
+#include "WindowGeometry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <GLES3/gl32.h>
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/render/OpenGL.hpp>
+#include <hyprland/src/render/Renderer.hpp>
+#include <hyprland/src/render/pass/PassElement.hpp>
+#include <hyprutils/math/Misc.hpp>
+
+// ── Snapshot pass element ────────────────────────────────────────────────────
+
+// Queued at RENDER_PRE_WINDOWS while the copy is incomplete. It claims live
+// blur over the whole monitor so the pass does not skip drawing the layers
+// under opaque windows, which the copy needs as much as the rest.
+class CBackdropSnapshotElement : public IPassElement {
+  public:
+    explicit CBackdropSnapshotElement(PHLMONITOR monitor) : m_monitor(monitor) {}
+
+    void draw(const CRegion& damage) override {
+        const auto monitor = m_monitor.lock();
+        if (!monitor || !g_pGlobalState)
+            return;
+
+        // Hyprland and other plugins drew since any of our elements last ran
+        g_pGlobalState->glState.invalidateContext();
+        g_pGlobalState->backdropCache.snapshot(monitor, damage);
+    }
+
+    [[nodiscard]] bool needsLiveBlur() override { return true; }
+    [[nodiscard]] bool needsPrecomputeBlur() override { return false; }
+    [[nodiscard]] bool disableSimplification() override { return true; }
+
+    [[nodiscard]] std::optional<CBox> boundingBox() override {
+        const auto monitor = m_monitor.lock();
+        if (!monitor)
+            return std::nullopt;
+        return CBox{{}, monitor->m_size};
+    }
+
+    [[nodiscard]] const char* passName() override { return "CBackdropSnapshotElement"; }
+
+  private:
+    PHLMONITORREF m_monitor;
+};
+
+// ── Copy ─────────────────────────────────────────────────────────────────────
+
+bool CBackdropCache::enabled() const {
+    const auto& backdropCache = g_pGlobalState->config.backdropCache;
+    return m_invalidationHooked && backdropCache && **backdropCache;
+}
+
+void CBackdropCache::SMonitorCache::invalidate() {
+    missing             = CBox{{}, snapshot.m_size};
+    invalidatedAt       = std::chrono::steady_clock::now();
+    completionRequested = false;
+
+    for (auto& entry : blurred)
+        entry->ready = false;
+}
+
+void CBackdropCache::onPreWindows(const PHLMONITOR& monitor) {
+    if (!enabled()) {
+        if (!m_monitors.empty())
+            release();
+        return;
+    }
+
+    releaseUnused();
+
+    // Only monitors where glass asked for a blur are copied
+    const auto found = m_monitors.find(monitor->m_id);
+    const auto source = g_pHyprOpenGL->m_renderData.currentFB;
+    if (found == m_monitors.end() || !source)
+        return;
+
+    // Whenever blurred() may serve the monitor this frame
+    updateCovers(monitor);
+
+    // Nor while glass is not drawn there: the snapshot's live blur would keep
+    // Hyprland from skipping what opaque windows cover
+    auto& cache = *found->second;
+    if (std::chrono::steady_clock::now() - cache.lastUsed > SNAPSHOT_IDLE_TIME)
+        return;
+
+    if (!cache.snapshot.isAllocated() || cache.snapshot.m_size != source->m_size) {
+        cache.snapshot.alloc(static_cast<int>(source->m_size.x), static_cast<int>(source->m_size.y), source->m_drmFormat);
+        cache.snapshotVram.set(framebufferBytes(cache.snapshot));
+        g_pGlobalState->glState.countAllocation();
+        g_pGlobalState->glState.invalidateContext();
+        cache.invalidate();
+    }
+
+    if (cache.missing.empty())
+        return;
+
+    // A fullscreen workspace may skip drawing the layers altogether
+    const auto workspace = monitor->m_activeWorkspace;
+    if (workspace && workspace->m_hasFullscreenWindow)
+        return;
+
+    // The layers went quiet with parts still missing: redraw them all once
+    if (!cache.completionRequested && std::chrono::steady_clock::now() - cache.invalidatedAt >= SETTLE_TIME) {
+        g_pHyprRenderer->damageMonitor(monitor);
+        cache.completionRequested = true;
+    }
+
+    g_pHyprRenderer->m_renderPass.add(makeUnique<CBackdropSnapshotElement>(monitor));
+}
+
+// ── Covers ───────────────────────────────────────────────────────────────────
+
+// One sweep up the windows the monitor renders: each decorated window gets the
+// union of those below it. Windows of another workspace (a slide, the special
+// workspace) count as below whatever their layer, as their relative drawing
+// order is not tracked.
+void CBackdropCache::updateCovers(const PHLMONITOR& monitor) {
+    struct SStacked {
+        size_t index; // into g_pCompositor->m_windows
+        int    layer;
+    };
+    // Kept between frames for its storage
+    static std::vector<SStacked> stack;
+
+    m_coverFrame++;
+    const auto& windows = g_pCompositor->m_windows;
+
+    stack.clear();
+    for (size_t i = 0; i < windows.size(); i++) {
+        const auto& window = windows[i];
+        if (window->m_fadingOut || g_pHyprRenderer->shouldRenderWindow(window, monitor))
+            stack.push_back({i, WindowGeometry::stackingLayer(window)});
+    }
+    // Bottom first: within a floating layer the later one is on top
+    std::ranges::sort(stack, [](const SStacked& a, const SStacked& b) { return a.layer != b.layer ? a.layer < b.layer : a.index < b.index; });
+
+    size_t usedCovers = 0;
+    auto   coverOf    = [&](const CWorkspace* workspace) -> CRegion& {
+        for (size_t i = 0; i < usedCovers; i++) {
+            if (m_workspaceCovers[i].workspace == workspace)
+                return m_workspaceCovers[i].region;
+        }
+        if (usedCovers == m_workspaceCovers.size())
+            m_workspaceCovers.emplace_back();
+        auto& cover     = m_workspaceCovers[usedCovers++];
+        cover.workspace = workspace;
+        return cover.region.clear();
+    };
+
+    auto& registry = g_pGlobalState->decorations;
+    for (const auto& stacked : stack) {
+        const auto& window    = windows[stacked.index];
+        const auto* workspace = window->m_workspace.get();
+
+        CBox box = window->getFullWindowBoundingBox();
+        if (window->m_workspace && !window->m_pinned)
+            box.translate(window->m_workspace->m_renderOffset->value());
+        box.translate(-monitor->m_position + window->m_floatingOffset).scale(monitor->m_scale).round();
+
+        auto& cover = coverOf(workspace);
+        if (auto* entry = registry.find(window.get())) {
+            const auto mainBox = WindowGeometry::computeWindowBox(window, monitor);
+            entry->coverBelow.set(cover);
+            if (mainBox)
+                entry->coverBelow.add(m_ring.set(box).subtract(*mainBox));
+            entry->coverFrame = m_coverFrame;
+        }
+        cover.add(box);
+    }
+
+    if (usedCovers < 2)
+        return;
+
+    for (const auto& stacked : stack) {
+        const auto& window = windows[stacked.index];
+        auto*       entry  = registry.find(window.get());
+        if (!entry)
+            continue;
+
+        for (size_t i = 0; i < usedCovers; i++) {
+            if (m_workspaceCovers[i].workspace != window->m_workspace.get())
+                entry->coverBelow.add(m_workspaceCovers[i].region);
+        }
+    }
+}
+
+void CBackdropCache::snapshot(const PHLMONITOR& monitor, const CRegion& damage) {
+    const auto found  = m_monitors.find(monitor->m_id);
+    const auto source = g_pHyprOpenGL->m_renderData.currentFB;
+    if (found == m_monitors.end() || !source)
+        return;
+
+    auto& cache = *found->second;
+    if (!cache.snapshot.isAllocated() || cache.snapshot.m_size != source->m_size)
+        return;
+
+    const auto transform = Math::wlTransformToHyprutils(Math::invertTransform(monitor->m_transform));
+    const auto copied    = damage.copy().transform(transform, monitor->m_transformedSize.x, monitor->m_transformedSize.y).intersect(cache.missing);
+    if (copied.empty())
+        return;
+
+    BlurPasses::copyShifted(*source, Vector2D(), cache.snapshot, copied);
+    cache.missing.subtract(copied);
+
+    g_pHyprOpenGL->scissor(nullptr);
+    g_pGlobalState->glState.bindFramebuffer(GL_FRAMEBUFFER, source->getFBID());
+}
+
+void CBackdropCache::invalidate(const PHLMONITOR& monitor) {
+    for (auto& [id, cache] : m_monitors) {
+        if (!monitor || id == monitor->m_id)
+            cache->invalidate();
+    }
+}
+
+// ── Blurs ────────────────────────────────────────────────────────────────────
+
+CFramebuffer* CBackdropCache::blurred(const PHLMONITOR& monitor, const SKernel& kernel, bool mayBuild) {
+    if (!monitor || !enabled())
+        return nullptr;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    auto& slot = m_monitors[monitor->m_id];
+    if (!slot) {
+        slot                = std::make_unique<SMonitorCache>();
+        slot->invalidatedAt = now;
+    }
+
+    auto& cache    = *slot;
+    cache.lastUsed = now;
+    if (!cache.snapshot.isAllocated() || !cache.missing.empty())
+        return nullptr;
+
+    auto entry = std::ranges::find_if(cache.blurred, [&kernel](const auto& candidate) { return candidate->kernel == kernel; });
+    if (entry == cache.blurred.end()) {
+        if (!mayBuild)
+            return nullptr;
+
+        cache.blurred.emplace_back(std::make_unique<SBlurred>());
+        entry            = std::prev(cache.blurred.end());
+        (*entry)->kernel = kernel;
+    }
+
+    auto& blurred    = **entry;
+    blurred.lastUsed = now;
+    if (blurred.ready)
+        return &blurred.framebuffer;
+    if (!mayBuild)
+        return nullptr;
+
+    auto&     glState = g_pGlobalState->glState;
+    const int width   = std::max(1, static_cast<int>(std::lround(cache.snapshot.m_size.x * kernel.sampleScale)));
+    const int height  = std::max(1, static_cast<int>(std::lround(cache.snapshot.m_size.y * kernel.sampleScale)));
+
+    // alloc() binds the new framebuffer and texture behind the state cache
+    if (!blurred.framebuffer.isAllocated() || blurred.framebuffer.m_size.x != width || blurred.framebuffer.m_size.y != height) {
+        blurred.framebuffer.alloc(width, height, cache.snapshot.m_drmFormat);
+        blurred.vram.set(framebufferBytes(blurred.framebuffer));
+        glState.countAllocation();
+    }
+
+    // Built once: a temp of its own rather than resizing the shared one back and forth
+    CFramebuffer temp;
+    if (kernel.iterations > 1) {
+        temp.alloc(width, height, cache.snapshot.m_drmFormat);
+        glState.countAllocation();
+    }
+    glState.invalidateContext();
+
+    const CBox fullRect = {0.0, 0.0, static_cast<double>(width), static_cast<double>(height)};
+    const auto pixels   = BlurPasses::render(cache.snapshot, Vector2D(), cache.snapshot.m_size, blurred.framebuffer, temp, fullRect, kernel.radius,
+                                             kernel.sampleScale, kernel.iterations);
+    g_pGlobalState->telemetry.countPixelsBlurred(pixels);
+
+    temp.release();
+    glState.invalidateContext();
+
+    blurred.ready = true;
+    return &blurred.framebuffer;
+}
+
+// ── Lifetime ─────────────────────────────────────────────────────────────────
+
+void CBackdropCache::releaseUnused() {
+    const auto now = std::chrono::steady_clock::now();
+
+    std::erase_if(m_monitors, [now](const auto& entry) { return now - entry.second->lastUsed > UNUSED_TIME; });
+    for (auto& [id, cache] : m_monitors)
+        std::erase_if(cache->blurred, [now](const auto& blurred) { return now - blurred->lastUsed > UNUSED_TIME; });
+}
+
+void CBackdropCache::release() {
+    // CFramebuffer frees its objects when destroyed; their names may be handed out again
+    m_monitors.clear();
+    g_pGlobalState->glState.invalidateContext();
+}
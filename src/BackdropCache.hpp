@@ -0,0 +1,103 @@
+#pragma once
+
+#include "VramTracker.hpp"
+
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <hyprland/src/render/Framebuffer.hpp>
+#include <hyprutils/math/Region.hpp>
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Per-monitor copy of the wallpaper and the bottom layer-shell layers, blurred
+// once per kernel in use. Glass copies its sample from here wherever nothing
+// but these layers is within blur reach, instead of blurring the monitor
+// framebuffer again every frame.
+//
+// Render passes are deferred, so the copy is taken by a pass element queued at
+// RENDER_PRE_WINDOWS: it runs once the layers are drawn and before the first
+// window. Only the frame's damage is drawn, so the copy fills up over frames;
+// once the layers have been quiet for SETTLE_TIME the monitor is damaged once
+// to finish it. Hyprland marks a monitor's blur dirty whenever one of these
+// layers changes, and a hook on that throws the copy and its blurs away: an
+// animated wallpaper keeps the cache empty.
+class CBackdropCache {
+  public:
+    struct SKernel {
+        float radius      = 0.0f; // source pixels
+        int   iterations  = 0;
+        float sampleScale = 1.0f;
+
+        bool operator==(const SKernel&) const = default;
+    };
+
+    // Without the hook the cache cannot tell when the layers change: it stays off
+    void setInvalidationHooked(bool hooked) noexcept { m_invalidationHooked = hooked; }
+    [[nodiscard]] bool enabled() const;
+
+    // RENDER_PRE_WINDOWS of the monitor being rendered
+    void onPreWindows(const PHLMONITOR& monitor);
+    // From the snapshot pass element: copy the layers drawn so far (damage in monitor pixels)
+    void snapshot(const PHLMONITOR& monitor, const CRegion& damage);
+    // A background or bottom layer of the monitor changed (null: all monitors)
+    void invalidate(const PHLMONITOR& monitor);
+
+    // Frame whose covers the registry entries hold when theirs match
+    // (CDecorationRegistry::SEntry::coverBelow)
+    [[nodiscard]] uint64_t coverFrame() const noexcept { return m_coverFrame; }
+
+    // All blur passes but the fused vertical one over the monitor's layers, in
+    // monitor framebuffer pixels × kernel.sampleScale. nullptr until the copy
+    // is complete. The blur is built on first use, which allocates: only when
+    // mayBuild. Building changes the framebuffer, texture and viewport bindings.
+    [[nodiscard]] CFramebuffer* blurred(const PHLMONITOR& monitor, const SKernel& kernel, bool mayBuild);
+
+    void release();
+
+    static constexpr auto SETTLE_TIME = std::chrono::milliseconds(500);
+    // The copy stops filling up once no glass asked for a blur in this long
+    static constexpr auto SNAPSHOT_IDLE_TIME = std::chrono::milliseconds(500);
+    // Monitors and kernels no glass asked for in this long are freed
+    static constexpr auto UNUSED_TIME = std::chrono::seconds(5);
+
+  private:
+    struct SBlurred {
+        SKernel         kernel;
+        CFramebuffer    framebuffer;
+        CVramAllocation vram{VRAM_BACKDROP_CACHE};
+        bool            ready = false;
+
+        std::chrono::steady_clock::time_point lastUsed;
+    };
+
+    struct SMonitorCache {
+        CFramebuffer    snapshot;
+        CVramAllocation snapshotVram{VRAM_BACKDROP_CACHE};
+        CRegion         missing; // framebuffer pixels not copied since the last invalidation
+
+        std::chrono::steady_clock::time_point invalidatedAt;
+        bool                                  completionRequested = false;
+        std::chrono::steady_clock::time_point lastUsed;
+
+        std::vector<std::unique_ptr<SBlurred>> blurred;
+
+        void invalidate();
+    };
+
+    bool                                                          m_invalidationHooked = false;
+    std::unordered_map<MONITORID, std::unique_ptr<SMonitorCache>> m_monitors;
+
+    // Covers of the monitor being rendered, and their scratch
+    struct SWorkspaceCover {
+        const CWorkspace* workspace = nullptr;
+        CRegion           region;
+    };
+    uint64_t                     m_coverFrame = 0;
+    std::vector<SWorkspaceCover> m_workspaceCovers;
+    CRegion                      m_ring;
+
+    void releaseUnused();
+    void updateCovers(const PHLMONITOR& monitor);
+};
@@ -0,0 +1,113 @@
+#include "BackdropProbe.hpp"
+#include "Globals.hpp"
+
+#include <algorithm>
+
+CBackdropProbe::~CBackdropProbe() {
+    release();
+}
+
+void CBackdropProbe::release() noexcept {
+    for (auto& slot : m_slots) {
+        if (slot.fence)
+            glDeleteSync(slot.fence);
+        if (slot.buffer)
+            glDeleteBuffers(1, &slot.buffer);
+        slot = {};
+    }
+
+    if (m_drawFramebuffer)
+        glDeleteFramebuffers(1, &m_drawFramebuffer);
+    if (m_readFramebuffer)
+        glDeleteFramebuffers(1, &m_readFramebuffer);
+    if (m_texture)
+        glDeleteTextures(1, &m_texture);
+
+    m_drawFramebuffer = 0;
+    m_readFramebuffer = 0;
+    m_texture         = 0;
+    m_nextSlot        = 0;
+    m_vram.set(0);
+}
+
+void CBackdropProbe::allocate() {
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexStorage2D(GL_TEXTURE_2D, READBACK_LEVEL + 1, GL_RGBA16F, REDUCTION_SIZE, REDUCTION_SIZE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glGenFramebuffers(1, &m_drawFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_drawFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, 0);
+
+    glGenFramebuffers(1, &m_readFramebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_readFramebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture, READBACK_LEVEL);
+
+    for (auto& slot : m_slots) {
+        glGenBuffers(1, &slot.buffer);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, READBACK_BYTES, nullptr, GL_STREAM_READ);
+    }
+
+    size_t bytes = READBACK_SLOTS * READBACK_BYTES;
+    for (int level = 0; level <= READBACK_LEVEL; level++)
+        bytes += static_cast<size_t>(REDUCTION_SIZE >> level) * (REDUCTION_SIZE >> level) * 8; // RGBA16F
+    m_vram.set(bytes);
+    g_pGlobalState->glState.countAllocation();
+}
+
+bool CBackdropProbe::beginCapture() {
+    if (!m_texture)
+        allocate();
+
+    // Oldest readback not collected yet
+    return !m_slots[m_nextSlot].fence;
+}
+
+GlassPasses::SProbeTarget CBackdropProbe::target() const noexcept {
+    return {m_drawFramebuffer, m_readFramebuffer, m_texture, REDUCTION_SIZE, READBACK_SIZE, m_slots[m_nextSlot].buffer};
+}
+
+void CBackdropProbe::endCapture(GLsync fence) {
+    m_slots[m_nextSlot].fence = fence;
+    m_nextSlot                = (m_nextSlot + 1) % m_slots.size();
+}
+
+bool CBackdropProbe::poll() {
+    bool changed = false;
+
+    // Each texel: (mean luminance, luminance variance) over its area
+    const auto onTexels = [&](const float* texels) {
+        constexpr int TEXELS = READBACK_SIZE * READBACK_SIZE;
+
+        float sum = 0.0f, detail = 0.0f;
+        for (int texel = 0; texel < TEXELS; texel++) {
+            sum += texels[texel * 4];
+            detail += texels[texel * 4 + 1];
+        }
+
+        const float mean = sum / TEXELS;
+        m_detail = std::max(detail / TEXELS, 0.0f);
+        changed |= !m_hasReading || mean != m_luminance;
+        m_luminance  = mean;
+        m_hasReading = true;
+    };
+
+    // Slots complete in submission order: start from the oldest
+    for (size_t i = 0; i < m_slots.size(); i++) {
+        auto& slot = m_slots[(m_nextSlot + i) % m_slots.size()];
+        if (slot.fence && !GlassPasses::collectReadback(g_pGlobalState->passContext, slot.fence, slot.buffer, READBACK_BYTES, onTexels))
+            break;
+    }
+
+    if (m_hasReading) {
+        if (m_prefersDark && m_luminance > THEME_THRESHOLD + THEME_HYSTERESIS)
+            m_prefersDark = false;
+        else if (!m_prefersDark && m_luminance < THEME_THRESHOLD - THEME_HYSTERESIS)
+            m_prefersDark = true;
+    }
+
+    return changed;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "GlassPasses.hpp"
+#include "VramTracker.hpp"
+
+#include <GLES3/gl32.h>
+#include <array>
+#include <cstddef>
+
+// Statistics of what is behind a window, measured on the GPU and read back
+// asynchronously: the average luminance for the automatic theme, and how
+// much fine detail a blur would smooth out, to skip blurring when none.
+//
+// The caller must only capture pixels drawn again this frame below the window:
+// elsewhere the monitor framebuffer holds last frame's composite, the glass
+// tinted by the theme being decided and the window's own content.
+//
+// Between beginCapture() and endCapture(), the caller runs
+// GlassPasses::measure() on target(): the backdropstats shader draws into the
+// 64×64 RGBA16F level, each texel the mean and the variance of luminance taps
+// over its footprint. The mipmaps reduce them, and a read of the 4×4 level is
+// queued into a pixel pack buffer guarded by a fence. poll() maps a buffer
+// only once its fence has signaled, a few frames later, so the frame never
+// waits on the GPU.
+class CBackdropProbe {
+  public:
+    CBackdropProbe() = default;
+    ~CBackdropProbe();
+
+    CBackdropProbe(const CBackdropProbe&)            = delete;
+    CBackdropProbe& operator=(const CBackdropProbe&) = delete;
+
+    static constexpr int REDUCTION_SIZE = 64;
+
+    // False while every readback slot is still in flight: skip this capture.
+    // Allocates on first use, changing the framebuffer and texture bindings.
+    [[nodiscard]] bool                      beginCapture();
+    [[nodiscard]] GlassPasses::SProbeTarget target() const noexcept;
+    // fence: guards the readback measure() queued
+    void endCapture(GLsync fence);
+
+    // Collect finished readbacks. Returns true if the luminance changed.
+    bool poll();
+
+    void release() noexcept;
+
+    [[nodiscard]] size_t vramBytes() const noexcept { return m_vram.bytes(); }
+
+    [[nodiscard]] bool  hasReading() const noexcept { return m_hasReading; }
+    [[nodiscard]] float luminance() const noexcept { return m_luminance; }
+    // Mean luminance variance within 1/64 of the window: near 0 over flat
+    // colours and smooth gradients, where a blur would change nothing
+    [[nodiscard]] float detail() const noexcept { return m_detail; }
+
+    // Dark/light decision with hysteresis around the mid grey, so a backdrop
+    // hovering near the threshold does not flip the theme every frame
+    [[nodiscard]] bool prefersDarkTheme() const noexcept { return m_prefersDark; }
+
+  private:
+    static constexpr int    READBACK_LEVEL   = 4; // 64 >> 4 = 4×4 texels
+    static constexpr int    READBACK_SIZE    = REDUCTION_SIZE >> READBACK_LEVEL;
+    static constexpr size_t READBACK_BYTES   = READBACK_SIZE * READBACK_SIZE * 4 * sizeof(float);
+    static constexpr size_t READBACK_SLOTS   = 3;
+    static constexpr float  THEME_THRESHOLD  = 0.5f;
+    static constexpr float  THEME_HYSTERESIS = 0.05f;
+
+    struct SSlot {
+        GLuint buffer = 0;
+        GLsync fence  = nullptr;
+    };
+
+    GLuint                             m_texture           = 0;
+    GLuint                             m_drawFramebuffer   = 0; // level 0
+    GLuint                             m_readFramebuffer   = 0; // readback level
+    std::array<SSlot, READBACK_SLOTS>  m_slots;
+    size_t                             m_nextSlot          = 0;
+    CVramAllocation                    m_vram{VRAM_BACKDROP_PROBE};
+
+    bool  m_hasReading        = false;
+    float m_luminance         = 0.0f;
+    float m_detail            = 0.0f;
+    bool  m_prefersDark       = true;
+
+    void allocate();
+};
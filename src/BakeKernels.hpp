@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+// CPU bakes of the glass shaders' lookup textures. No Hyprland dependency:
+// shared by the plugin and tools/hyprglass-replay, so a replay samples the
+// same texels the plugin uploaded.
+namespace BakeKernels {
+
+// Rounded-box SDF and edge proximity of one corner (CEdgeFieldTexture): a
+// size × size tile of (sdf, edgeProximity) at pixel centers, RG interleaved.
+// Same math as getRoundedBoxSDF() in the shader, with p folded so that
+// abs(p) - halfSize == -distanceToEdge.
+inline void edgeField(float cornerRadius, float roundingPower, float bezelWidthPx, int size, std::vector<float>& texels) {
+    const float r     = cornerRadius;
+    const float power = roundingPower;
+    const float bezel = bezelWidthPx;
+
+    texels.resize(static_cast<size_t>(size) * size * 2);
+
+    for (int iy = 0; iy < size; iy++) {
+        const float qy = r - (static_cast<float>(iy) + 0.5f);
+
+        for (int ix = 0; ix < size; ix++) {
+            const float qx = r - (static_cast<float>(ix) + 0.5f);
+
+            float outside = 0.0f;
+            if (qx > 0.0f && qy > 0.0f)
+                outside = std::pow(std::pow(qx, power) + std::pow(qy, power), 1.0f / power);
+            else
+                outside = std::max({qx, qy, 0.0f});
+
+            const float sdf       = std::min(std::max(qx, qy), 0.0f) + outside - r;
+            const float proximity = bezel > 0.0f ? std::exp(sdf / bezel) : 0.0f;
+
+            const size_t texel = (static_cast<size_t>(iy) * size + ix) * 2;
+            texels[texel]      = sdf;
+            texels[texel + 1]  = proximity;
+        }
+    }
+}
+
+// Inputs of the frosted tint and the tint overlay (CToneLuts)
+struct STone {
+    float                brightness       = 0.0f;
+    float                contrast         = 0.0f;
+    float                saturation       = 0.0f;
+    float                vibrancy         = 0.0f;
+    float                vibrancyDarkness = 0.0f;
+    float                adaptiveDim      = 0.0f;
+    float                adaptiveBoost    = 0.0f;
+    std::array<float, 3> tintColor        = {};
+    float                tintAlpha        = 0.0f;
+
+    bool operator==(const STone&) const = default;
+};
+
+// Texels per axis of the tone LUT: input 0 and 1 land on the first and last texel centers
+inline constexpr int TONE_LUT_SIZE = 33;
+
+using ToneRow = std::array<float, TONE_LUT_SIZE>;
+
+// One row of the LUT (red varies, green and blue fixed): the frosted tint of
+// liquidglass.frag, step for step. Branch-free over plain arrays so the
+// compiler runs it across SIMD lanes.
+inline void toneMapRow(const STone& tone, const ToneRow& inR, float inG, float inB, ToneRow& outR, ToneRow& outG, ToneRow& outB) {
+    constexpr float LUM_R = 0.2126f;
+    constexpr float LUM_G = 0.7152f;
+    constexpr float LUM_B = 0.0722f;
+
+    for (int i = 0; i < TONE_LUT_SIZE; i++) {
+        float r = inR[i];
+        float g = inG;
+        float b = inB;
+
+        const float blurredLum = LUM_R * r + LUM_G * g + LUM_B * b;
+
+        // Frosted desaturation
+        r = blurredLum + (r - blurredLum) * tone.saturation;
+        g = blurredLum + (g - blurredLum) * tone.saturation;
+        b = blurredLum + (b - blurredLum) * tone.saturation;
+
+        // smoothstep(0.25, 0.55, blurredLum)
+        const float t        = std::min(std::max((blurredLum - 0.25f) / 0.3f, 0.0f), 1.0f);
+        const float lumCurve = t * t * (3.0f - 2.0f * t);
+
+        const float dim   = tone.brightness * (1.0f - tone.adaptiveDim * lumCurve);
+        const float boost = tone.adaptiveBoost * (1.0f - lumCurve) * 0.5f;
+        r                 = r * dim + boost;
+        g                 = g * dim + boost;
+        b                 = b * dim + boost;
+
+        // Contrast (pivot around midpoint)
+        r = 0.5f + (r - 0.5f) * tone.contrast;
+        g = 0.5f + (g - 0.5f) * tone.contrast;
+        b = 0.5f + (b - 0.5f) * tone.contrast;
+
+        // Vibrancy
+        const float currentLum = LUM_R * r + LUM_G * g + LUM_B * b;
+        const float sat        = std::max(r, std::max(g, b)) - std::min(r, std::min(g, b));
+        const float darkFactor = 1.0f - tone.vibrancyDarkness * (1.0f - blurredLum);
+        const float vibrance   = 1.0f + tone.vibrancy * sat * darkFactor;
+        r                      = currentLum + (r - currentLum) * vibrance;
+        g                      = currentLum + (g - currentLum) * vibrance;
+        b                      = currentLum + (b - currentLum) * vibrance;
+
+        // Color tint overlay
+        outR[i] = r + (tone.tintColor[0] - r) * tone.tintAlpha;
+        outG[i] = g + (tone.tintColor[1] - g) * tone.tintAlpha;
+        outB[i] = b + (tone.tintColor[2] - b) * tone.tintAlpha;
+    }
+}
+
+// The whole TONE_LUT_SIZE³ LUT, RGBA interleaved, red fastest
+inline void toneLut(const STone& tone, std::vector<float>& texels) {
+    constexpr int SIZE = TONE_LUT_SIZE;
+
+    ToneRow axis;
+    for (int i = 0; i < SIZE; i++)
+        axis[i] = static_cast<float>(i) / static_cast<float>(SIZE - 1);
+
+    texels.resize(static_cast<size_t>(SIZE) * SIZE * SIZE * 4);
+
+    ToneRow outR, outG, outB;
+    for (int ib = 0; ib < SIZE; ib++) {
+        for (int ig = 0; ig < SIZE; ig++) {
+            toneMapRow(tone, axis, axis[ig], axis[ib], outR, outG, outB);
+
+            float* row = &texels[(static_cast<size_t>(ib) * SIZE + ig) * SIZE * 4];
+            for (int ir = 0; ir < SIZE; ir++) {
+                row[ir * 4]     = outR[ir];
+                row[ir * 4 + 1] = outG[ir];
+                row[ir * 4 + 2] = outB[ir];
+                row[ir * 4 + 3] = 1.0f;
+            }
+        }
+    }
+}
+
+} // namespace BakeKernels
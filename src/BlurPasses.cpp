@@ -0,0 +1,164 @@
+#include "BlurPasses.hpp"
+#include "Globals.hpp"
+
+#include <GLES3/gl32.h>
+#include <hyprland/src/render/OpenGL.hpp>
+
+namespace BlurPasses {
+
+// ── Context ──────────────────────────────────────────────────────────────────
+
+void CPassContext::useProgram(const SP<CShader>& shader, const std::array<float, 9>& projection) {
+    auto& glState = g_pGlobalState->glState;
+    auto  current = glState.useShader(shader);
+    current->setUniformMatrix3fv(SHADER_PROJ, 1, GL_FALSE, projection);
+    current->setUniformInt(SHADER_TEX, 0);
+    glState.bindVertexArray(current->getUniformLocation(SHADER_SHADER_VAO));
+}
+
+void CPassContext::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    g_pGlobalState->glState.bindFramebuffer(target, framebuffer);
+}
+
+void CPassContext::bindTexture(GLuint unit, GLuint texture, GLenum target) {
+    g_pGlobalState->glState.bindTexture(unit, texture, target);
+}
+
+void CPassContext::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    g_pGlobalState->glState.setViewport(x, y, width, height);
+}
+
+void CPassContext::uniform1i(GLint location, GLint value) {
+    g_pGlobalState->glState.uniform1i(location, value);
+}
+
+void CPassContext::uniform1f(GLint location, GLfloat value) {
+    g_pGlobalState->glState.uniform1f(location, value);
+}
+
+void CPassContext::uniform2f(GLint location, GLfloat x, GLfloat y) {
+    g_pGlobalState->glState.uniform2f(location, x, y);
+}
+
+void CPassContext::uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+    g_pGlobalState->glState.uniform4f(location, x, y, z, w);
+}
+
+uint64_t CPassContext::drawGrown(const CRegion& region, double grow, int width, int height) {
+    m_drawn.set(region);
+    if (grow > 0.0)
+        m_drawn.expand(grow);
+    m_drawn.intersect(CBox{0.0, 0.0, static_cast<double>(width), static_cast<double>(height)});
+    return drawScissored(m_drawn, false);
+}
+
+uint64_t CPassContext::drawClipped(const CRegion& region, double x, double y, double width, double height) {
+    m_drawn.set(region).intersect(CBox{x, y, width, height});
+    return drawScissored(m_drawn, true);
+}
+
+uint64_t CPassContext::blit(const CRegion& region, const std::array<int, 4>& source, const std::array<int, 4>& target, GLenum filter) {
+    // The scissor clips glBlitFramebuffer on the DRAW framebuffer: set it per
+    // rect in its pixels, replacing the render pass's own scissor (in monitor
+    // pixels) that would otherwise leak here.
+    uint64_t pixels = 0;
+    for (const auto& rect : rects(region)) {
+        g_pHyprOpenGL->scissor(CBox(rect.x1, rect.y1, rect.x2 - rect.x1, rect.y2 - rect.y1), false);
+        glBlitFramebuffer(source[0], source[1], source[2], source[3], target[0], target[1], target[2], target[3], GL_COLOR_BUFFER_BIT, filter);
+
+        const uint64_t rectPixels = static_cast<uint64_t>(rect.x2 - rect.x1) * static_cast<uint64_t>(rect.y2 - rect.y1);
+        g_pGlobalState->glState.countDraw(rectPixels);
+        pixels += rectPixels;
+    }
+    return pixels;
+}
+
+void CPassContext::generateMipmap(GLenum target) {
+    glGenerateMipmap(target);
+}
+
+void CPassContext::readPixels(GLuint buffer, GLint x, GLint y, GLsizei width, GLsizei height) {
+    // Into a pixel pack buffer: queued, not a synchronous readback
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    glReadPixels(x, y, width, height, GL_RGBA, GL_FLOAT, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+GLsync CPassContext::fenceSync() {
+    return glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+bool CPassContext::fenceSignaled(GLsync fence) {
+    // No timeout: a poll
+    const GLenum status = glClientWaitSync(fence, 0, 0);
+    return status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED;
+}
+
+void CPassContext::deleteSync(GLsync fence) {
+    glDeleteSync(fence);
+}
+
+const void* CPassContext::mapBuffer(GLuint buffer, size_t bytes) {
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer);
+    const void* texels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT);
+    if (!texels)
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    return texels;
+}
+
+void CPassContext::unmapBuffer() {
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+uint64_t drawScissored(const CRegion& region, bool transformRects) {
+    uint64_t pixels = 0;
+    for (const auto& rect : rects(region)) {
+        g_pHyprOpenGL->scissor(CBox(rect.x1, rect.y1, rect.x2 - rect.x1, rect.y2 - rect.y1), transformRects);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+        const uint64_t rectPixels = static_cast<uint64_t>(rect.x2 - rect.x1) * static_cast<uint64_t>(rect.y2 - rect.y1);
+        g_pGlobalState->glState.countDraw(rectPixels);
+        pixels += rectPixels;
+    }
+    return pixels;
+}
+
+// ── Passes ───────────────────────────────────────────────────────────────────
+
+GlassPasses::SBuffer buffer(CFramebuffer& framebuffer) {
+    const auto texture = framebuffer.getTexture();
+    return {framebuffer.getFBID(), texture ? texture->m_texID : 0, static_cast<int>(framebuffer.m_size.x), static_cast<int>(framebuffer.m_size.y)};
+}
+
+uint64_t sampleCopy(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent, CFramebuffer& target, const CRegion& damage) {
+    return GlassPasses::sampleCopy(g_pGlobalState->passContext, buffer(source), {origin.x, origin.y}, {extent.x, extent.y}, buffer(target), damage);
+}
+
+uint64_t copyShifted(CFramebuffer& source, const Vector2D& offset, CFramebuffer& target, const CRegion& damage) {
+    return GlassPasses::copyShifted(g_pGlobalState->passContext, buffer(source), {static_cast<int>(offset.x), static_cast<int>(offset.y)}, buffer(target),
+                                    damage);
+}
+
+uint64_t render(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent, CFramebuffer& target, CFramebuffer& temp,
+                const CRegion& damage, float radius, float sampleScale, int iterations) {
+    const auto& shaderManager = g_pGlobalState->shaderManager;
+    return GlassPasses::render(g_pGlobalState->passContext, shaderManager.blurShader, shaderManager.blurUniforms, buffer(source), {origin.x, origin.y},
+                               {extent.x, extent.y}, buffer(target), buffer(temp), damage, radius, sampleScale, iterations);
+}
+
+uint64_t stochastic(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent, CFramebuffer& target, CFramebuffer& history,
+                    const Vector2D& historyOffset, float historyWeight, float radius, float sampleScale, int iterations, uint32_t frame) {
+    const auto& shaderManager = g_pGlobalState->shaderManager;
+    const auto  whole         = CRegion(CBox{0.0, 0.0, target.m_size.x, target.m_size.y});
+    return GlassPasses::stochastic(g_pGlobalState->passContext, shaderManager.stochasticBlurShader, shaderManager.stochasticBlurUniforms, buffer(source),
+                                   {origin.x, origin.y}, {extent.x, extent.y}, buffer(target), buffer(history), whole,
+                                   {historyOffset.x, historyOffset.y}, historyWeight, GlassPasses::chainSigmaPx(radius, sampleScale, iterations), frame);
+}
+
+Vector2D chainSigmaPx(float radius, float sampleScale, int iterations) {
+    const auto sigma = GlassPasses::chainSigmaPx(radius, sampleScale, iterations);
+    return Vector2D(sigma[0], sigma[1]);
+}
+
+} // namespace BlurPasses
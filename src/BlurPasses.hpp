@@ -0,0 +1,87 @@
+#pragma once
+
+#include "GlassPasses.hpp"
+
+#include <hyprland/src/render/Framebuffer.hpp>
+#include <hyprland/src/render/Shader.hpp>
+#include <hyprutils/math/Region.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// The plugin's side of GlassPasses: its GL context, and the separable blur
+// shared by the per-window sample and the backdrop cache. Both stop one pass
+// short: the last vertical pass runs inside the glass shader, so a cached
+// result and a freshly blurred one are the same intermediate and can be
+// mixed within one sample.
+namespace BlurPasses {
+
+// GlassPasses context: binds and uniforms go through the state cache,
+// programs through Hyprland, which tracks the current one, and scissors
+// through Hyprland, so composite rects in monitor pixels follow the monitor
+// transform. Every draw and blit is counted.
+class CPassContext {
+  public:
+    void useProgram(const SP<CShader>& shader, const std::array<float, 9>& projection);
+    void bindFramebuffer(GLenum target, GLuint framebuffer);
+    void bindTexture(GLuint unit, GLuint texture, GLenum target);
+    void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    void uniform1i(GLint location, GLint value);
+    void uniform1f(GLint location, GLfloat value);
+    void uniform2f(GLint location, GLfloat x, GLfloat y);
+    void uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+
+    // In target pixels
+    uint64_t drawGrown(const CRegion& region, double grow, int width, int height);
+    // In monitor pixels
+    uint64_t drawClipped(const CRegion& region, double x, double y, double width, double height);
+    // In draw framebuffer pixels
+    uint64_t blit(const CRegion& region, const std::array<int, 4>& source, const std::array<int, 4>& target, GLenum filter);
+
+    void        generateMipmap(GLenum target);
+    void        readPixels(GLuint buffer, GLint x, GLint y, GLsizei width, GLsizei height);
+    GLsync      fenceSync();
+    bool        fenceSignaled(GLsync fence);
+    void        deleteSync(GLsync fence);
+    const void* mapBuffer(GLuint buffer, size_t bytes);
+    void        unmapBuffer();
+
+  private:
+    // The region actually drawn, kept for its storage
+    CRegion m_drawn;
+};
+
+// The rects of a region in place: getRects() copies them into a new vector
+[[nodiscard]] inline std::span<const pixman_box32_t> rects(const CRegion& region) {
+    int         count = 0;
+    const auto* boxes = pixman_region32_rectangles(const_cast<CRegion&>(region).pixman(), &count);
+    return {boxes, static_cast<size_t>(count)};
+}
+
+// Draws the bound quad once per rect of the region, each under its own scissor.
+// transformRects: the rects are in monitor pixels rather than framebuffer pixels.
+// Returns the number of pixels drawn.
+uint64_t drawScissored(const CRegion& region, bool transformRects);
+
+[[nodiscard]] GlassPasses::SBuffer buffer(CFramebuffer& framebuffer);
+
+// GlassPasses::sampleCopy() from the source rect (origin, extent) onto the whole target
+uint64_t sampleCopy(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent, CFramebuffer& target, const CRegion& damage);
+
+// GlassPasses::copyShifted() of the source, shifted by offset, onto the target
+uint64_t copyShifted(CFramebuffer& source, const Vector2D& offset, CFramebuffer& target, const CRegion& damage);
+
+// GlassPasses::render() with the plugin's blur shader
+uint64_t render(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent, CFramebuffer& target, CFramebuffer& temp,
+                const CRegion& damage, float radius, float sampleScale, int iterations);
+
+// GlassPasses::stochastic() with the plugin's stochastic blur shader
+uint64_t stochastic(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent, CFramebuffer& target, CFramebuffer& history,
+                    const Vector2D& historyOffset, float historyWeight, float radius, float sampleScale, int iterations, uint32_t frame);
+
+[[nodiscard]] Vector2D chainSigmaPx(float radius, float sampleScale, int iterations);
+
+} // namespace BlurPasses
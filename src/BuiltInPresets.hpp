@@ -37,8 +37,22 @@ namespace GlobalDefaults {
     inline constexpr float   EDGE_THICKNESS       = 0.06f;
     inline constexpr int64_t TINT_COLOR           = 0x8899aa22;
     inline constexpr float   LENS_DISTORTION      = 0.5f;
+    inline constexpr int64_t BACKDROP_FPS         = 0; // every frame
 } // namespace GlobalDefaults
 
+// ── Level of detail thresholds ───────────────────────────────────────────────
+// Area: fraction of the monitor covered by the window. Visible: fraction of
+// the window not hidden behind opaque windows. Below a threshold → that tier.
+
+namespace LodDefaults {
+    inline constexpr float MEDIUM_AREA    = 0.08f;
+    inline constexpr float LOW_AREA       = 0.02f;
+    inline constexpr float MEDIUM_VISIBLE = 0.6f;
+    inline constexpr float LOW_VISIBLE    = 0.25f;
+    // Backdrop detail (mean local luminance variance) under which blurring is skipped
+    inline constexpr float UNIFORM_BACKDROP_THRESHOLD = 0.0001f;
+} // namespace LodDefaults
+
 // ── Built-in presets ─────────────────────────────────────────────────────────
 // To add a new built-in preset: define a make*() function and register it
 // in getAll().
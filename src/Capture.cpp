@@ -0,0 +1,208 @@
+#include "Capture.hpp"
+#include "Globals.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <format>
+#include <GLES3/gl32.h>
+#include <hyprland/src/helpers/Color.hpp>
+#include <hyprland/src/render/OpenGL.hpp>
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ── Control ──────────────────────────────────────────────────────────────────
+
+std::string CCaptureRecorder::start(std::string_view args) {
+    if (active())
+        return std::format("already capturing to {}", m_path);
+
+    m_backdrops = args == "backdrop" || args.starts_with("backdrop ");
+    if (m_backdrops)
+        args.remove_prefix(std::min(args.size(), std::string_view("backdrop").size()));
+    while (!args.empty() && args.front() == ' ')
+        args.remove_prefix(1);
+
+    if (args.empty()) {
+        const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+        const auto  seconds    = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        m_path = std::format("{}/hyprglass-capture-{}.hgcap", runtimeDir ? runtimeDir : "/tmp", seconds);
+    } else
+        m_path = args;
+
+    m_file.open(m_path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+        return std::format("failed to open {}", m_path);
+
+    const Capture::SFileHeader header = {
+        .magic    = Capture::MAGIC,
+        .version  = Capture::VERSION,
+        .passSize = sizeof(Capture::SPass),
+        .flags    = m_backdrops ? Capture::FILE_BACKDROPS : 0u,
+    };
+    m_bytes = 0;
+    if (!writeBytes(&header, sizeof(header)))
+        return std::format("failed to write {}", m_path);
+
+    m_passOpen       = false;
+    m_frameHasPasses = false;
+    m_passes         = 0;
+    m_frames         = 0;
+    m_dropped        = 0;
+
+    return std::format("capturing{} to {}", m_backdrops ? " with backdrops" : "", m_path);
+}
+
+std::string CCaptureRecorder::stop() {
+    if (!active())
+        return "not capturing";
+
+    m_file.close();
+    m_passOpen = false;
+
+    std::string result = std::format("wrote {} passes in {} frames to {}", m_passes, m_frames, m_path);
+    if (m_dropped)
+        result += std::format(" ({} records dropped over the size limit)", m_dropped);
+    return result;
+}
+
+void CCaptureRecorder::release() {
+    if (active())
+        m_file.close();
+
+    m_passOpen = false;
+    m_pending  = {};
+    m_backdropFramebuffer.release();
+}
+
+// ── Records ──────────────────────────────────────────────────────────────────
+
+bool CCaptureRecorder::beginRecord(Capture::eRecord type, size_t bytes) {
+    if (m_bytes + sizeof(Capture::SRecordHeader) + bytes > MAX_BYTES) {
+        m_dropped++;
+        return false;
+    }
+
+    const Capture::SRecordHeader header = {static_cast<uint32_t>(type), static_cast<uint32_t>(bytes)};
+    return writeBytes(&header, sizeof(header));
+}
+
+bool CCaptureRecorder::writeBytes(const void* data, size_t bytes) {
+    if (!active())
+        return false;
+
+    m_file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    if (!m_file) {
+        // Disk full or the like: the file holds every record before this one,
+        // the replay drops the partial one at its end
+        m_file.close();
+        m_passOpen = false;
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::format("[hyprglass] Capture stopped: writing {} failed after {} passes in {} frames.", m_path, m_passes, m_frames)},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.2, 0.2, 1.0}},
+        });
+        return false;
+    }
+
+    m_bytes += bytes;
+    return true;
+}
+
+CCaptureRecorder::SPendingPass* CCaptureRecorder::beginPass() {
+    if (!active())
+        return nullptr;
+
+    // Cleared, not freed: the buffers serve every pass of the capture
+    m_pending.pass = {};
+    m_pending.damage.clear();
+    m_pending.blurred.clear();
+    m_pending.cached.clear();
+    m_pending.backdrop.clear();
+
+    m_pending.pass.timestampNs = nowNs();
+    m_passOpen                 = true;
+    return &m_pending;
+}
+
+void CCaptureRecorder::endPass() {
+    if (!m_passOpen)
+        return;
+    m_passOpen = false;
+
+    auto& pass        = m_pending.pass;
+    pass.damageRects  = static_cast<uint32_t>(m_pending.damage.size());
+    pass.blurredRects = static_cast<uint32_t>(m_pending.blurred.size());
+    pass.cachedRects  = static_cast<uint32_t>(m_pending.cached.size());
+
+    const size_t rectBytes = sizeof(Capture::SRect) * (m_pending.damage.size() + m_pending.blurred.size() + m_pending.cached.size());
+    if (!beginRecord(Capture::RECORD_PASS, sizeof(pass) + rectBytes + m_pending.backdrop.size()))
+        return;
+
+    if (!writeBytes(&pass, sizeof(pass)) || !writeBytes(m_pending.damage.data(), sizeof(Capture::SRect) * m_pending.damage.size()) ||
+        !writeBytes(m_pending.blurred.data(), sizeof(Capture::SRect) * m_pending.blurred.size()) ||
+        !writeBytes(m_pending.cached.data(), sizeof(Capture::SRect) * m_pending.cached.size()) ||
+        !writeBytes(m_pending.backdrop.data(), m_pending.backdrop.size()))
+        return;
+
+    m_passes++;
+    m_frameHasPasses = true;
+}
+
+void CCaptureRecorder::endFrame(int64_t monitorId) {
+    if (!active() || !m_frameHasPasses)
+        return;
+    m_frameHasPasses = false;
+
+    const Capture::SFrameEnd frameEnd = {nowNs(), monitorId};
+    if (!beginRecord(Capture::RECORD_FRAME_END, sizeof(frameEnd)))
+        return;
+
+    if (writeBytes(&frameEnd, sizeof(frameEnd)))
+        m_frames++;
+}
+
+void CCaptureRecorder::appendRects(std::vector<Capture::SRect>& rects, const CRegion& region) {
+    for (const auto& rect : region.getRects())
+        rects.push_back({rect.x1, rect.y1, rect.x2, rect.y2});
+}
+
+// ── Backdrop ─────────────────────────────────────────────────────────────────
+
+void CCaptureRecorder::captureBackdrop(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent) {
+    if (!m_backdrops || !m_passOpen || extent.x <= 0.0 || extent.y <= 0.0)
+        return;
+
+    const double scale  = std::min(1.0, Capture::BACKDROP_MAX_SIZE / std::max(extent.x, extent.y));
+    const int    width  = std::max(1, static_cast<int>(std::lround(extent.x * scale)));
+    const int    height = std::max(1, static_cast<int>(std::lround(extent.y * scale)));
+
+    auto& glState = g_pGlobalState->glState;
+
+    // alloc() binds the new framebuffer and texture behind the state cache
+    if (!m_backdropFramebuffer.isAllocated() || m_backdropFramebuffer.m_size.x != width || m_backdropFramebuffer.m_size.y != height) {
+        m_backdropFramebuffer.alloc(width, height, source.m_drmFormat);
+        glState.countAllocation();
+        glState.invalidateContext();
+    }
+
+    const int x0 = static_cast<int>(origin.x);
+    const int y0 = static_cast<int>(origin.y);
+
+    g_pHyprOpenGL->scissor(nullptr);
+    glState.bindFramebuffer(GL_READ_FRAMEBUFFER, source.getFBID());
+    glState.bindFramebuffer(GL_DRAW_FRAMEBUFFER, m_backdropFramebuffer.getFBID());
+    glBlitFramebuffer(x0, y0, x0 + static_cast<int>(extent.x), y0 + static_cast<int>(extent.y), 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glState.countDraw(static_cast<uint64_t>(width) * static_cast<uint64_t>(height));
+
+    m_pending.backdrop.resize(static_cast<size_t>(width) * height * 4);
+    glState.bindFramebuffer(GL_READ_FRAMEBUFFER, m_backdropFramebuffer.getFBID());
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, m_pending.backdrop.data());
+    glState.countStallProneCall();
+
+    m_pending.pass.backdropWidth  = static_cast<uint32_t>(width);
+    m_pending.pass.backdropHeight = static_cast<uint32_t>(height);
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CaptureFormat.hpp"
+
+#include <hyprland/src/render/Framebuffer.hpp>
+#include <hyprutils/math/Region.hpp>
+#include <hyprutils/math/Vector2D.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Records what each window render pass sees to a capture file (see
+// CaptureFormat.hpp), for tools/hyprglass-replay. Toggled through hyprctl;
+// while off, beginPass() is the only cost.
+//
+// Records are streamed to the file as passes end. Backdrop copies are read
+// back synchronously: they stall the pipeline once per pass, and are meant
+// for short captures of a problem rather than for timing the compositor.
+class CCaptureRecorder {
+  public:
+    struct SPendingPass {
+        Capture::SPass              pass = {};
+        std::vector<Capture::SRect> damage;
+        std::vector<Capture::SRect> blurred;
+        std::vector<Capture::SRect> cached;
+        std::vector<uint8_t>        backdrop;
+    };
+
+    [[nodiscard]] bool active() const noexcept { return m_file.is_open(); }
+
+    // hyprctl entry points: return a status line for the caller.
+    // args: "[backdrop] [path]"
+    [[nodiscard]] std::string start(std::string_view args);
+    [[nodiscard]] std::string stop();
+
+    // The pass the current renderPass records into, nullptr unless capturing.
+    // Filled in as the pass runs and written by endPass().
+    [[nodiscard]] SPendingPass* beginPass();
+    [[nodiscard]] SPendingPass* pendingPass() noexcept { return m_passOpen ? &m_pending : nullptr; }
+    void                        endPass();
+
+    // End of a monitor frame (RENDER_POST)
+    void endFrame(int64_t monitorId);
+
+    // Downscaled copy of the padded rect (source pixels) into the pending
+    // pass, when capturing backdrops. Changes the framebuffer bindings.
+    void captureBackdrop(CFramebuffer& source, const Vector2D& origin, const Vector2D& extent);
+
+    static void appendRects(std::vector<Capture::SRect>& rects, const CRegion& region);
+
+    // Closes the file, frees the readback buffer (context must be current)
+    void release();
+
+    // Bounds the file if a capture is left running
+    static constexpr uint64_t MAX_BYTES = 1ull << 30;
+
+  private:
+    std::ofstream m_file;
+    std::string   m_path;
+    bool          m_backdrops = false;
+
+    SPendingPass m_pending;
+    bool         m_passOpen       = false;
+    bool         m_frameHasPasses = false;
+    uint64_t     m_bytes          = 0;
+    uint64_t     m_passes         = 0;
+    uint64_t     m_frames         = 0;
+    uint64_t     m_dropped        = 0;
+
+    CFramebuffer m_backdropFramebuffer;
+
+    // Writes the record header; false past MAX_BYTES (the record counted as
+    // dropped) or once a write failed
+    bool beginRecord(Capture::eRecord type, size_t bytes);
+    // A failed write stops the capture and says so; false from then on
+    bool writeBytes(const void* data, size_t bytes);
+};
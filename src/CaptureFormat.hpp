@@ -0,0 +1,128 @@
+#pragma once
+
+#include "BakeKernels.hpp"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// Layout of a frame-input capture (hyprctl hyprglass capture), shared by the
+// plugin (the writer) and tools/hyprglass-replay. Bump VERSION on any change.
+//
+// An SFileHeader, then records: an SRecordHeader followed by `bytes` of
+// payload. Each window render pass is one RECORD_PASS: an SPass, its rects
+// (damage, then blurred, then cached), then the backdrop pixels if any. A
+// RECORD_FRAME_END closes every monitor frame that recorded a pass.
+//
+// A pass holds what the GL work of that renderPass depended on, resolved:
+// the boxes, the projection, the path the sample took and the regions it
+// covered, the uniforms and the inputs of the baked textures. Replaying it
+// issues the same draws; what the plugin decided on the CPU is taken as is.
+namespace Capture {
+
+inline constexpr uint32_t MAGIC   = 0x50434748; // "HGCP"
+inline constexpr uint32_t VERSION = 1;
+
+// Longest side of a captured backdrop, in pixels
+inline constexpr uint32_t BACKDROP_MAX_SIZE = 128;
+
+enum eFileFlags : uint32_t {
+    FILE_BACKDROPS = 1 << 0, // passes carry a downscaled copy of their backdrop
+};
+
+struct SFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t passSize; // sizeof(SPass) of the writer
+    uint32_t flags;
+};
+
+enum eRecord : uint32_t {
+    RECORD_PASS      = 1,
+    RECORD_FRAME_END = 2,
+};
+
+struct SRecordHeader {
+    uint32_t type;
+    uint32_t bytes;
+};
+
+// How the sample was brought up to date
+enum ePath : uint8_t {
+    PATH_REUSE = 0,  // left as it was
+    PATH_COPY,       // unblurred blit of the damage
+    PATH_BLUR,       // separable passes over the damage, the rest from the backdrop cache
+    PATH_STOCHASTIC, // one-pass estimate of the whole rect
+};
+
+struct SRect {
+    int32_t x1, y1, x2, y2;
+};
+
+struct SPass {
+    uint64_t timestampNs; // CLOCK_MONOTONIC
+    uint64_t windowId;    // stable for as long as the window lives
+    int64_t  monitorId;
+    int32_t  monitorTransform;
+    float    monitorScale;
+    uint32_t framebufferWidth; // the monitor framebuffer the glass is drawn into
+    uint32_t framebufferHeight;
+
+    // Glass quad: projection as uploaded, box in framebuffer pixels (x, y, w, h)
+    std::array<float, 9> projection;
+    std::array<float, 4> box;
+    float                interiorInset; // 0: the bezel shader covers the whole box
+
+    // Sample: the padded rect in framebuffer pixels and the sample's own size
+    std::array<float, 2> sampleOrigin;
+    std::array<float, 2> sampleExtent;
+    uint32_t             sampleWidth;
+    uint32_t             sampleHeight;
+    float                sampleScale;
+    uint8_t              path;
+    uint8_t              lodTier;
+    uint8_t              steadyState;
+    uint8_t              reserved;
+    float                blurRadius; // framebuffer pixels
+    int32_t              blurIterations;
+
+    // PATH_STOCHASTIC
+    std::array<float, 2> stochasticSigma;  // framebuffer pixels
+    std::array<float, 2> historyOffset;    // sample pixels
+    float                historyWeight;
+    uint32_t             stochasticFrame;
+
+    // Composite uniforms
+    float                fusedBlurRadius;
+    std::array<float, 2> fusedBlurDirection;
+    std::array<float, 2> uvPadding;
+    float                refractionStrength;
+    float                chromaticAberration;
+    float                fresnelStrength;
+    float                specularStrength;
+    float                glassOpacity; // window alpha applied
+    float                lensDistortion;
+
+    // Baked textures
+    float              edgeCornerRadius;
+    float              edgeRoundingPower;
+    float              edgeBezelWidthPx;
+    int32_t            edgeFieldSize;
+    BakeKernels::STone tone;
+
+    uint32_t damageRects;  // framebuffer pixels
+    uint32_t blurredRects; // sample pixels: blurred, or copied on PATH_COPY
+    uint32_t cachedRects;  // sample pixels: copied from the backdrop cache
+    uint32_t backdropWidth; // RGBA8 copy of the padded rect, 0: none
+    uint32_t backdropHeight;
+};
+
+struct SFrameEnd {
+    uint64_t timestampNs;
+    int64_t  monitorId;
+};
+
+static_assert(std::is_trivially_copyable_v<SPass>);
+static_assert(std::is_trivially_copyable_v<SFrameEnd>);
+
+} // namespace Capture
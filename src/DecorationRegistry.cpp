@@ -0,0 +1,72 @@
+#include "DecorationRegistry.hpp"
+
+CDecorationRegistry::SHandle CDecorationRegistry::add(const PHLWINDOW& window, const WP<CGlassDecoration>& decoration) {
+    // A decoration the window dropped without closing leaves its entry behind
+    if (const auto found = m_byWindow.find(window.get()); found != m_byWindow.end())
+        erase(found->second);
+
+    uint32_t index;
+    if (!m_freeSlots.empty()) {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    auto& slot = m_slots[index];
+    slot.entry = static_cast<uint32_t>(m_entries.size());
+
+    const SHandle handle = {index, slot.generation};
+    m_entries.push_back({decoration, window.get(), handle, {}, 1.0, {}, 0});
+    m_byWindow[window.get()] = handle;
+    return handle;
+}
+
+void CDecorationRegistry::remove(const PHLWINDOW& window) {
+    const auto found = m_byWindow.find(window.get());
+    if (found == m_byWindow.end())
+        return;
+
+    erase(found->second);
+}
+
+void CDecorationRegistry::erase(SHandle handle) {
+    auto&      slot  = m_slots[handle.index];
+    const auto entry = slot.entry;
+
+    m_byWindow.erase(m_entries[entry].window);
+
+    if (entry + 1 != m_entries.size()) {
+        m_entries[entry] = std::move(m_entries.back());
+        m_slots[m_entries[entry].handle.index].entry = entry;
+    }
+    m_entries.pop_back();
+
+    slot.generation++;
+    m_freeSlots.push_back(handle.index);
+}
+
+void CDecorationRegistry::clear() {
+    m_entries.clear();
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_byWindow.clear();
+}
+
+bool CDecorationRegistry::contains(const PHLWINDOW& window) const {
+    const auto found = m_byWindow.find(window.get());
+    return found != m_byWindow.end() && !m_entries[m_slots[found->second.index].entry].decoration.expired();
+}
+
+CDecorationRegistry::SEntry* CDecorationRegistry::get(SHandle handle) {
+    if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+        return nullptr;
+
+    return &m_entries[m_slots[handle.index].entry];
+}
+
+CDecorationRegistry::SEntry* CDecorationRegistry::find(const CWindow* window) {
+    const auto found = m_byWindow.find(window);
+    return found == m_byWindow.end() ? nullptr : &m_entries[m_slots[found->second.index].entry];
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <hyprutils/math/Region.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+class CGlassDecoration;
+
+// Every glass decoration, keyed by its window. Entries sit packed in one
+// array, so sweeps over all windows (VRAM budget, idle release) walk
+// contiguous memory and cull on the per-window state kept there before
+// touching a decoration. Opening or closing a window costs the same however
+// many there are: removal moves the last entry into the gap.
+//
+// Handles stay valid while their entry moves around; a removed entry's slot
+// gets a new generation, so a handle outliving its window resolves to nothing.
+class CDecorationRegistry {
+  public:
+    struct SHandle {
+        uint32_t index      = std::numeric_limits<uint32_t>::max();
+        uint32_t generation = 0;
+
+        bool operator==(const SHandle&) const = default;
+    };
+
+    struct SEntry {
+        WP<CGlassDecoration>                  decoration; // owned by the window
+        const CWindow*                        window = nullptr;
+        SHandle                               handle;
+        std::chrono::steady_clock::time_point lastRenderedAt;
+        // Share of the main surface not behind opaque windows, refreshed
+        // once per monitor frame by LevelOfDetail::updateVisibility()
+        double                                visibleFraction = 1.0;
+        // What Hyprland draws over the monitor's layers before the window's
+        // glass pass: the windows below it and its own shadow and border
+        // (monitor pixels). Set once per monitor frame by CBackdropCache while
+        // it serves the monitor, in its frame coverFrame.
+        CRegion                               coverBelow;
+        uint64_t                              coverFrame = 0;
+    };
+
+    SHandle add(const PHLWINDOW& window, const WP<CGlassDecoration>& decoration);
+    void    remove(const PHLWINDOW& window);
+    void    clear();
+
+    // Whether the window already has a live decoration
+    [[nodiscard]] bool    contains(const PHLWINDOW& window) const;
+    [[nodiscard]] SEntry* get(SHandle handle);
+    [[nodiscard]] SEntry* find(const CWindow* window);
+
+    // Live and expired entries alike, in no particular order
+    [[nodiscard]] std::span<SEntry>       entries() { return m_entries; }
+    [[nodiscard]] std::span<const SEntry> entries() const { return m_entries; }
+
+  private:
+    struct SSlot {
+        uint32_t entry      = 0; // into m_entries while in use
+        uint32_t generation = 0;
+    };
+
+    std::vector<SEntry>                         m_entries;
+    std::vector<SSlot>                          m_slots;
+    std::vector<uint32_t>                       m_freeSlots;
+    std::unordered_map<const CWindow*, SHandle> m_byWindow;
+
+    void erase(SHandle handle);
+};
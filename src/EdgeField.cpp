@@ -0,0 +1,48 @@
+#include "EdgeField.hpp"
+#include "BakeKernels.hpp"
+#include "Globals.hpp"
+
+#include <algorithm>
+
+CEdgeFieldTexture::~CEdgeFieldTexture() {
+    release();
+}
+
+void CEdgeFieldTexture::release() noexcept {
+    if (m_texture)
+        glDeleteTextures(1, &m_texture);
+
+    m_texture = 0;
+    m_key     = {};
+    m_vram.set(0);
+}
+
+bool CEdgeFieldTexture::update(float cornerRadius, float roundingPower, float bezelWidthPx, int size) {
+    const SKey key = {cornerRadius, roundingPower, bezelWidthPx, std::max(size, 1)};
+    if (m_texture && key == m_key)
+        return false;
+
+    m_key = key;
+    bake();
+    return true;
+}
+
+void CEdgeFieldTexture::bake() {
+    const int size = m_key.size;
+    BakeKernels::edgeField(m_key.cornerRadius, m_key.roundingPower, m_key.bezelWidthPx, size, m_texels);
+
+    if (!m_texture) {
+        glGenTextures(1, &m_texture);
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    } else
+        glBindTexture(GL_TEXTURE_2D, m_texture);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, size, size, 0, GL_RG, GL_FLOAT, m_texels.data());
+    m_vram.set(static_cast<size_t>(size) * size * 2 * sizeof(float));
+    g_pGlobalState->glState.countAllocation();
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "VramTracker.hpp"
+
+#include <GLES3/gl32.h>
+#include <vector>
+
+// Baked rounded-box SDF and edge proximity for the glass shader.
+//
+// The field of one corner is enough: folded into the first quadrant, the SDF
+// only depends on the distance to the two nearest edges, and past the corner
+// radius it no longer depends on the larger one. The texture holds a
+// size × size tile of (sdf, edgeProximity) at pixel centers, indexed by the
+// pixel distance to the nearest vertical and horizontal edge (clamped).
+class CEdgeFieldTexture {
+  public:
+    CEdgeFieldTexture() = default;
+    ~CEdgeFieldTexture();
+
+    CEdgeFieldTexture(const CEdgeFieldTexture&)            = delete;
+    CEdgeFieldTexture& operator=(const CEdgeFieldTexture&) = delete;
+
+    // Re-bake only if one of the inputs changed since the last call. Returns
+    // true if it did: the active unit's GL_TEXTURE_2D binding is then 0.
+    bool update(float cornerRadius, float roundingPower, float bezelWidthPx, int size);
+    void release() noexcept;
+
+    [[nodiscard]] GLuint texture() const noexcept { return m_texture; }
+    [[nodiscard]] int    size() const noexcept { return m_key.size; }
+    [[nodiscard]] size_t vramBytes() const noexcept { return m_vram.bytes(); }
+
+  private:
+    struct SKey {
+        float cornerRadius  = -1.0f;
+        float roundingPower = -1.0f;
+        float bezelWidthPx  = -1.0f;
+        int   size          = 0;
+
+        bool operator==(const SKey&) const = default;
+    };
+
+    GLuint             m_texture = 0;
+    SKey               m_key;
+    std::vector<float> m_texels;
+    CVramAllocation    m_vram{VRAM_EDGE_FIELD};
+
+    void bake();
+};
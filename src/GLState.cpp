@@ -0,0 +1,175 @@
+#include "GLState.hpp"
+
+#include <hyprland/src/render/OpenGL.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <format>
+
+void CGLStateCache::beginRenderPass() {
+    m_renderPasses++;
+
+    for (size_t i = 0; i < WORK_LAST; i++)
+        m_workAtPassStart[i] = m_work[i].total;
+}
+
+void CGLStateCache::endRenderPass(bool steadyState) {
+    std::array<uint64_t, WORK_LAST> pass = {};
+    for (size_t i = 0; i < WORK_LAST; i++) {
+        pass[i]           = m_work[i].total - m_workAtPassStart[i];
+        m_work[i].maxPass = std::max(m_work[i].maxPass, pass[i]);
+    }
+
+    if (!steadyState)
+        return;
+
+    m_steadyStatePasses++;
+    if (pass[WORK_ALLOCATION] || pass[WORK_STALL_PRONE]) {
+        m_budgetViolations++;
+        m_lastBudgetViolation = std::format("steady-state pass with {} allocations and {} stall-prone calls",
+                                            pass[WORK_ALLOCATION], pass[WORK_STALL_PRONE]);
+    }
+}
+
+void CGLStateCache::countDraw(uint64_t pixels) noexcept {
+    m_work[WORK_DRAW].total++;
+    m_work[WORK_PIXELS].total += pixels;
+}
+
+void CGLStateCache::invalidateContext() {
+    m_readFramebuffer = UNKNOWN;
+    m_drawFramebuffer = UNKNOWN;
+    m_vertexArray     = UNKNOWN;
+    m_viewportKnown   = false;
+    invalidateTextures();
+}
+
+void CGLStateCache::invalidateTextures() {
+    m_activeUnit = UNKNOWN;
+    m_textures.fill(UNKNOWN);
+}
+
+void CGLStateCache::forgetUniforms() {
+    m_uniforms.clear();
+    m_program = 0;
+}
+
+bool CGLStateCache::count(eCounter which, bool changed) {
+    if (changed)
+        m_counters[which].issued++;
+    else
+        m_counters[which].skipped++;
+
+    return changed;
+}
+
+SP<CShader> CGLStateCache::useShader(const SP<CShader>& shader) {
+    m_program = shader->program();
+    return g_pHyprOpenGL->useShader(shader);
+}
+
+void CGLStateCache::bindFramebuffer(GLenum target, GLuint framebuffer) {
+    const bool read = target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER;
+    const bool draw = target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER;
+
+    const bool changed = (read && m_readFramebuffer != framebuffer) || (draw && m_drawFramebuffer != framebuffer);
+    if (!count(COUNTER_FRAMEBUFFER, changed))
+        return;
+
+    glBindFramebuffer(target, framebuffer);
+    if (read)
+        m_readFramebuffer = framebuffer;
+    if (draw)
+        m_drawFramebuffer = framebuffer;
+}
+
+void CGLStateCache::bindVertexArray(GLuint vertexArray) {
+    if (!count(COUNTER_VERTEX_ARRAY, m_vertexArray != vertexArray))
+        return;
+
+    glBindVertexArray(vertexArray);
+    m_vertexArray = vertexArray;
+}
+
+void CGLStateCache::bindTexture(GLuint unit, GLuint texture, GLenum target) {
+    if (unit >= TEXTURE_UNITS) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        m_activeUnit = unit;
+        return;
+    }
+
+    if (!count(COUNTER_TEXTURE, m_textures[unit] != texture))
+        return;
+
+    if (count(COUNTER_TEXTURE, m_activeUnit != unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        m_activeUnit = unit;
+    }
+
+    glBindTexture(target, texture);
+    m_textures[unit] = texture;
+}
+
+void CGLStateCache::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    const std::array<GLint, 4> viewport = {x, y, width, height};
+    if (!count(COUNTER_VIEWPORT, !m_viewportKnown || m_viewport != viewport))
+        return;
+
+    g_pHyprOpenGL->setViewport(x, y, width, height);
+    m_viewport      = viewport;
+    m_viewportKnown = true;
+}
+
+bool CGLStateCache::uniformChanged(GLint location, const SUniformValue& value) {
+    if (location < 0)
+        return false;
+
+    auto& values = m_uniforms[m_program];
+    if (values.size() <= static_cast<size_t>(location))
+        values.resize(location + 1);
+
+    auto& cached = values[location];
+    if (!count(COUNTER_UNIFORM, cached != value))
+        return false;
+
+    cached = value;
+    return true;
+}
+
+void CGLStateCache::uniform1i(GLint location, GLint value) {
+    if (uniformChanged(location, {{std::bit_cast<uint32_t>(value)}, 1}))
+        glUniform1i(location, value);
+}
+
+void CGLStateCache::uniform1f(GLint location, GLfloat value) {
+    if (uniformChanged(location, {{std::bit_cast<uint32_t>(value)}, 1}))
+        glUniform1f(location, value);
+}
+
+void CGLStateCache::uniform2f(GLint location, GLfloat x, GLfloat y) {
+    if (uniformChanged(location, {{std::bit_cast<uint32_t>(x), std::bit_cast<uint32_t>(y)}, 2}))
+        glUniform2f(location, x, y);
+}
+
+void CGLStateCache::uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z) {
+    if (uniformChanged(location, {{std::bit_cast<uint32_t>(x), std::bit_cast<uint32_t>(y), std::bit_cast<uint32_t>(z)}, 3}))
+        glUniform3f(location, x, y, z);
+}
+
+void CGLStateCache::uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+    if (uniformChanged(location,
+                       {{std::bit_cast<uint32_t>(x), std::bit_cast<uint32_t>(y), std::bit_cast<uint32_t>(z), std::bit_cast<uint32_t>(w)}, 4}))
+        glUniform4f(location, x, y, z, w);
+}
+
+void CGLStateCache::resetCounters() noexcept {
+    m_counters.fill({});
+    m_renderPasses = 0;
+
+    m_work.fill({});
+    m_workAtPassStart.fill(0);
+    m_steadyStatePasses = 0;
+    m_budgetViolations  = 0;
+    m_lastBudgetViolation.clear();
+}
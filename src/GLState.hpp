@@ -0,0 +1,128 @@
+#pragma once
+
+#include <GLES3/gl32.h>
+#include <hyprland/src/render/Shader.hpp>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Shadow of the GL state the plugin sets, so binds and uniform uploads that
+// match what is already current are never issued.
+//
+// Context state (framebuffers, VAO, texture units, viewport) is shared with
+// Hyprland and every other pass element: it is forgotten at the start of each
+// renderPass, and after anything that binds behind the cache's back
+// (framebuffer allocation, texture uploads). Uniform values live in the
+// plugin's own programs, which nothing else touches, so they stay cached
+// across frames until the programs are destroyed.
+//
+// It also accounts for the GL work of each window render pass and checks it
+// against the steady-state budget: a pass that only refreshes its damage must
+// not allocate a framebuffer or texture, nor issue a call that can stall the pipeline
+// (glGet*, glFinish, synchronous readbacks).
+class CGLStateCache {
+  public:
+    enum eCounter : uint8_t {
+        COUNTER_FRAMEBUFFER = 0,
+        COUNTER_VERTEX_ARRAY,
+        COUNTER_TEXTURE,
+        COUNTER_VIEWPORT,
+        COUNTER_UNIFORM,
+        COUNTER_LAST,
+    };
+
+    struct SCounter {
+        uint64_t issued  = 0;
+        uint64_t skipped = 0;
+    };
+
+    // Work that is never redundant, so never skipped: only counted
+    enum eWork : uint8_t {
+        WORK_DRAW = 0, // draws and blits
+        WORK_PIXELS,   // pixels they touched
+        WORK_ALLOCATION, // framebuffers and textures
+        WORK_STALL_PRONE,
+        WORK_LAST,
+    };
+
+    struct SWork {
+        uint64_t total   = 0;
+        uint64_t maxPass = 0; // most in a single render pass
+    };
+
+    // Start of one window's render pass: counts it and opens its work tally
+    void beginRenderPass();
+    // End of a pass that ran to completion. steadyState: it reused its sample
+    // and only refreshed the damage, so the budget applies.
+    void endRenderPass(bool steadyState);
+    void invalidateContext();
+    void invalidateTextures();
+    void forgetUniforms();
+
+    // Routed through Hyprland, which tracks the current program itself;
+    // remembered here to key the uniform cache
+    SP<CShader> useShader(const SP<CShader>& shader);
+
+    void bindFramebuffer(GLenum target, GLuint framebuffer);
+    void bindVertexArray(GLuint vertexArray);
+    // On GL_TEXTURE0 + unit; each unit is only ever used with one target
+    void bindTexture(GLuint unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
+    void setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // Uniforms of the program last set through useShader()
+    void uniform1i(GLint location, GLint value);
+    void uniform1f(GLint location, GLfloat value);
+    void uniform2f(GLint location, GLfloat x, GLfloat y);
+    void uniform3f(GLint location, GLfloat x, GLfloat y, GLfloat z);
+    void uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+
+    void countDraw(uint64_t pixels) noexcept;
+    void countAllocation() noexcept { m_work[WORK_ALLOCATION].total++; }
+    void countStallProneCall() noexcept { m_work[WORK_STALL_PRONE].total++; }
+
+    [[nodiscard]] const SCounter&    counter(eCounter which) const { return m_counters[which]; }
+    [[nodiscard]] const SWork&       work(eWork which) const { return m_work[which]; }
+    [[nodiscard]] uint64_t           renderPasses() const noexcept { return m_renderPasses; }
+    [[nodiscard]] uint64_t           steadyStatePasses() const noexcept { return m_steadyStatePasses; }
+    [[nodiscard]] uint64_t           budgetViolations() const noexcept { return m_budgetViolations; }
+    [[nodiscard]] const std::string& lastBudgetViolation() const noexcept { return m_lastBudgetViolation; }
+    void                             resetCounters() noexcept;
+
+  private:
+    static constexpr GLuint UNKNOWN       = ~0u;
+    static constexpr size_t TEXTURE_UNITS = 3;
+
+    struct SUniformValue {
+        std::array<uint32_t, 4> bits       = {};
+        uint8_t                 components = 0; // 0: never uploaded
+
+        bool operator==(const SUniformValue&) const = default;
+    };
+
+    GLuint                                m_readFramebuffer = UNKNOWN;
+    GLuint                                m_drawFramebuffer = UNKNOWN;
+    GLuint                                m_vertexArray     = UNKNOWN;
+    GLuint                                m_activeUnit      = UNKNOWN;
+    std::array<GLuint, TEXTURE_UNITS>     m_textures = {UNKNOWN, UNKNOWN, UNKNOWN};
+    std::array<GLint, 4>                  m_viewport = {};
+    bool                                  m_viewportKnown = false;
+
+    GLuint                                                 m_program = 0;
+    std::unordered_map<GLuint, std::vector<SUniformValue>> m_uniforms;
+
+    std::array<SCounter, COUNTER_LAST> m_counters;
+    uint64_t                           m_renderPasses = 0;
+
+    std::array<SWork, WORK_LAST>    m_work;
+    std::array<uint64_t, WORK_LAST> m_workAtPassStart = {};
+    uint64_t                        m_steadyStatePasses = 0;
+    uint64_t                        m_budgetViolations  = 0;
+    std::string                     m_lastBudgetViolation;
+
+    // True if the value differs from the cached one (and records it)
+    [[nodiscard]] bool uniformChanged(GLint location, const SUniformValue& value);
+    [[nodiscard]] bool count(eCounter which, bool changed);
+};
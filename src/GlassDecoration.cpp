@@ -1,12 +1,16 @@
 #include "GlassDecoration.hpp"
-#include "BuiltInPresets.hpp"
+#include "BlurPasses.hpp"
 #include "GlassPassElement.hpp"
 #include "Globals.hpp"
+#include "Trace.hpp"
 #include "WindowGeometry.hpp"
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstring>
 #include <GLES3/gl32.h>
+#include <hyprland/src/Compositor.hpp>
 #include <hyprland/src/desktop/view/Window.hpp>
 #include <hyprland/src/desktop/rule/windowRule/WindowRuleApplicator.hpp>
 #include <hyprland/src/render/OpenGL.hpp>
@@ -17,36 +21,65 @@ CGlassDecoration::CGlassDecoration(PHLWINDOW window)
     : IHyprWindowDecoration(window), m_window(window) {
 }
 
-bool CGlassDecoration::resolveThemeIsDark() const {
+// What a tag selects after the prefix, without the '*' that marks dynamic tags.
+// Views into the tag: resolution runs every frame and must not allocate.
+static std::optional<std::string_view> taggedValue(std::string_view tag, std::string_view prefix) {
+    if (!tag.starts_with(prefix))
+        return std::nullopt;
+
+    tag.remove_prefix(prefix.size());
+    if (tag.ends_with('*'))
+        tag.remove_suffix(1);
+    return tag;
+}
+
+eThemeMode CGlassDecoration::resolveThemeMode() const {
     try {
         const auto window = m_window.lock();
         if (window && window->m_ruleApplicator) {
-            const std::string lightTag = std::string(TAG_THEME_PREFIX) + "light";
-            const std::string darkTag  = std::string(TAG_THEME_PREFIX) + "dark";
-            if (window->m_ruleApplicator->m_tagKeeper.isTagged(lightTag))
-                return false;
-            if (window->m_ruleApplicator->m_tagKeeper.isTagged(darkTag))
-                return true;
+            // light wins over dark, dark over auto, whatever the tag order
+            std::optional<eThemeMode> tagged;
+            for (const auto& tag : window->m_ruleApplicator->m_tagKeeper.getTags()) {
+                const auto theme = taggedValue(tag, TAG_THEME_PREFIX);
+                if (theme == "light")
+                    return THEME_LIGHT;
+                if (theme == "dark")
+                    tagged = THEME_DARK;
+                else if (theme == "auto" && !tagged)
+                    tagged = THEME_AUTO;
+            }
+            if (tagged)
+                return *tagged;
         }
 
         const auto& config = g_pGlobalState->config;
         if (config.defaultTheme) {
             const char* theme = *config.defaultTheme;
-            if (theme)
-                return std::string_view(theme) != "light";
+            if (theme && std::string_view(theme) == "light")
+                return THEME_LIGHT;
+            if (theme && std::string_view(theme) == "auto")
+                return THEME_AUTO;
         }
     } catch (...) {}
 
-    return true;
+    return THEME_DARK;
 }
 
-std::string CGlassDecoration::resolvePresetName() const {
+bool CGlassDecoration::resolveThemeIsDark() const {
+    switch (resolveThemeMode()) {
+        case THEME_LIGHT: return false;
+        case THEME_AUTO: return m_backdropProbe.prefersDarkTheme();
+        default: return true;
+    }
+}
+
+PresetId CGlassDecoration::resolvePresetId() const {
     try {
         const auto window = m_window.lock();
         if (window && window->m_ruleApplicator) {
             for (const auto& tag : window->m_ruleApplicator->m_tagKeeper.getTags()) {
-                if (tag.starts_with(TAG_PRESET_PREFIX))
-                    return tag.substr(TAG_PRESET_PREFIX.size());
+                if (const auto preset = taggedValue(tag, TAG_PRESET_PREFIX))
+                    return findPresetId(*preset);
             }
         }
 
@@ -54,11 +87,11 @@ std::string CGlassDecoration::resolvePresetName() const {
         if (config.defaultPreset) {
             const char* preset = *config.defaultPreset;
             if (preset && preset[0] != '\0')
-                return std::string(preset);
+                return findPresetId(preset);
         }
     } catch (...) {}
 
-    return "default";
+    return DEFAULT_PRESET_ID;
 }
 
 SDecorationPositioningInfo CGlassDecoration::getPositioningInfo() {
@@ -72,75 +105,95 @@ SDecorationPositioningInfo CGlassDecoration::getPositioningInfo() {
 void CGlassDecoration::onPositioningReply(const SDecorationPositioningReply& reply) {}
 
 void CGlassDecoration::draw(PHLMONITOR monitor, float const& alpha) {
+    TRACE_CPU_ZONE("draw");
+
     if (!**g_pGlobalState->config.enabled)
         return;
 
+    const auto window = m_window.lock();
+    if (!window)
+        return;
+
+    // The pass element asks for live blur and opts out of simplification, which
+    // keeps the whole monitor on the composite path: leave it out while none of
+    // the glass can show. The sample is not kept up to date in the meantime.
+    if (!glassCanShow(window)) {
+        m_sampleState.reset();
+        return;
+    }
+
+    growFrameDamage(window, monitor);
+
     CGlassPassElement::SGlassPassData data{this, alpha};
     g_pHyprRenderer->m_renderPass.add(makeUnique<CGlassPassElement>(data));
 
-    const auto window = m_window.lock();
-    if (window) {
-        const auto workspace = window->m_workspace;
+    const auto workspace = window->m_workspace;
 
-        if (workspace && !window->m_pinned && workspace->m_renderOffset->isBeingAnimated())
-            damageEntire();
+    if (workspace && !window->m_pinned && workspace->m_renderOffset->isBeingAnimated())
+        damageEntire();
 
-        const auto currentPosition = window->m_realPosition->value();
-        const auto currentSize = window->m_realSize->value();
-        if (currentPosition != m_lastPosition || currentSize != m_lastSize) {
-            damageEntire();
-            m_lastPosition = currentPosition;
-            m_lastSize = currentSize;
-        }
+    const auto currentPosition = window->m_realPosition->value();
+    const auto currentSize = window->m_realSize->value();
+    if (currentPosition != m_lastPosition || currentSize != m_lastSize) {
+        damageEntire();
+        m_lastPosition = currentPosition;
+        m_lastSize = currentSize;
     }
 }
 
+bool CGlassDecoration::glassCanShow(const PHLWINDOW& window) const {
+    // The glass only shows through the window: an opaque one hides all of it,
+    // which covers fullscreen games and video
+    if (window->opaque())
+        return false;
+
+    // Fully behind opaque windows, a fullscreen one included
+    const auto* entry = g_pGlobalState->decorations.get(m_handle);
+    return !entry || entry->visibleFraction > 0.0;
+}
+
 PHLWINDOW CGlassDecoration::getOwner() {
     return m_window.lock();
 }
 
-void CGlassDecoration::sampleBackground(CFramebuffer& sourceFramebuffer, CBox box) {
+void CGlassDecoration::prepareSampleFramebuffer(CFramebuffer& sourceFramebuffer, const CBox& box, float sampleScale) {
     const int pad = SAMPLE_PADDING_PX;
-    int paddedWidth  = static_cast<int>(box.width) + 2 * pad;
-    int paddedHeight = static_cast<int>(box.height) + 2 * pad;
-
-    if (m_sampleFramebuffer.m_size.x != paddedWidth || m_sampleFramebuffer.m_size.y != paddedHeight)
-        m_sampleFramebuffer.alloc(paddedWidth, paddedHeight, sourceFramebuffer.m_drmFormat);
-
-    int srcX0 = static_cast<int>(box.x) - pad;
-    int srcX1 = static_cast<int>(box.x + box.width) + pad;
-    int srcY0 = static_cast<int>(box.y) - pad;
-    int srcY1 = static_cast<int>(box.y + box.height) + pad;
 
-    // Clamp source coordinates to framebuffer bounds to avoid reading black/undefined pixels
-    int framebufferWidth  = static_cast<int>(sourceFramebuffer.m_size.x);
-    int framebufferHeight = static_cast<int>(sourceFramebuffer.m_size.y);
+    m_sampleOrigin = Vector2D(box.x - pad, box.y - pad);
+    m_sampleExtent = Vector2D(static_cast<int>(box.width) + 2 * pad, static_cast<int>(box.height) + 2 * pad);
+    m_sampleScale  = sampleScale;
 
-    int dstX0 = 0, dstY0 = 0, dstX1 = paddedWidth, dstY1 = paddedHeight;
+    int paddedWidth  = std::max(1, static_cast<int>(std::lround(m_sampleExtent.x * sampleScale)));
+    int paddedHeight = std::max(1, static_cast<int>(std::lround(m_sampleExtent.y * sampleScale)));
 
-    if (srcX0 < 0) { dstX0 += -srcX0; srcX0 = 0; }
-    if (srcY0 < 0) { dstY0 += -srcY0; srcY0 = 0; }
-    if (srcX1 > framebufferWidth)  { dstX1 -= (srcX1 - framebufferWidth);  srcX1 = framebufferWidth; }
-    if (srcY1 > framebufferHeight) { dstY1 -= (srcY1 - framebufferHeight); srcY1 = framebufferHeight; }
+    // alloc() binds the new framebuffer and texture behind the state cache
+    if (!m_sampleFramebuffer.isAllocated() || m_sampleFramebuffer.m_size.x != paddedWidth || m_sampleFramebuffer.m_size.y != paddedHeight) {
+        m_sampleFramebuffer.alloc(paddedWidth, paddedHeight, sourceFramebuffer.m_drmFormat);
+        m_sampleVram.set(framebufferBytes(m_sampleFramebuffer));
+        g_pGlobalState->telemetry.countFramebufferRealloc();
+        g_pGlobalState->glState.countAllocation();
+        g_pGlobalState->glState.invalidateContext();
+    }
 
     m_samplePaddingRatio = Vector2D(
-        static_cast<double>(pad) / paddedWidth,
-        static_cast<double>(pad) / paddedHeight
+        static_cast<double>(pad) / m_sampleExtent.x,
+        static_cast<double>(pad) / m_sampleExtent.y
     );
+}
 
-    // The render pass scissors each element to its damage region.
-    // That scissor state leaks here and clips glBlitFramebuffer on the
-    // DRAW framebuffer, causing partial writes and stale noise artifacts.
-    g_pHyprOpenGL->setCapStatus(GL_SCISSOR_TEST, false);
+void CGlassDecoration::sampleBackground(CFramebuffer& sourceFramebuffer, const CRegion& sampleDamage) {
+    TRACE_GPU_ZONE("sampleBackground");
+    const CTelemetryStageTimer stageTimer{Telemetry::STAGE_SAMPLE};
 
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, sourceFramebuffer.getFBID());
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_sampleFramebuffer.getFBID());
-    glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1,
-                      dstX0, dstY0, dstX1, dstY1,
-                      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    m_fusedBlur = {};
+    BlurPasses::sampleCopy(sourceFramebuffer, m_sampleOrigin, m_sampleExtent, m_sampleFramebuffer, sampleDamage);
 }
 
-void CGlassDecoration::blurBackground(float radius, int iterations, GLuint callerFramebufferID, int viewportWidth, int viewportHeight) {
+void CGlassDecoration::blurBackground(CFramebuffer& sourceFramebuffer, const CRegion& sampleDamage, float radius, int iterations,
+                                      GLuint callerFramebufferID, int viewportWidth, int viewportHeight) {
+    TRACE_GPU_ZONE("blurBackground");
+    const CTelemetryStageTimer stageTimer{Telemetry::STAGE_BLUR};
+
     auto& shaderManager = g_pGlobalState->shaderManager;
     if (radius <= 0.0f || iterations <= 0 || !shaderManager.isInitialized())
         return;
@@ -148,137 +201,293 @@ void CGlassDecoration::blurBackground(float radius, int iterations, GLuint calle
     int width  = static_cast<int>(m_sampleFramebuffer.m_size.x);
     int height = static_cast<int>(m_sampleFramebuffer.m_size.y);
 
+    // Everything damaged comes from the backdrop cache
+    if (sampleDamage.empty()) {
+        m_fusedBlur = {radius * m_sampleScale, Vector2D(0.0, 1.0 / height)};
+        return;
+    }
+
+    // The last vertical pass is fused into the glass shader, so a single
+    // iteration never touches the temp buffer
+    auto& glState             = g_pGlobalState->glState;
     auto& blurTempFramebuffer = g_pGlobalState->blurTempFramebuffer;
-    if (blurTempFramebuffer.m_size.x != width || blurTempFramebuffer.m_size.y != height)
+    if (iterations > 1 && (blurTempFramebuffer.m_size.x != width || blurTempFramebuffer.m_size.y != height)) {
         blurTempFramebuffer.alloc(width, height, m_sampleFramebuffer.m_drmFormat);
-
-    // Fullscreen quad projection: maps VAO positions [0,1] to clip space [-1,1]
-    static constexpr std::array<float, 9> FULLSCREEN_PROJECTION = {
-        2.0f, 0.0f, 0.0f,
-        0.0f, 2.0f, 0.0f,
-       -1.0f,-1.0f, 1.0f,
-    };
-
-    const auto& blurUniforms = shaderManager.blurUniforms;
-
-    auto shader = g_pHyprOpenGL->useShader(shaderManager.blurShader);
-    shader->setUniformMatrix3fv(SHADER_PROJ, 1, GL_FALSE, FULLSCREEN_PROJECTION);
-    shader->setUniformInt(SHADER_TEX, 0);
-    glUniform1f(blurUniforms.radius, radius);
-    glBindVertexArray(shader->getUniformLocation(SHADER_SHADER_VAO));
-    g_pHyprOpenGL->setViewport(0, 0, width, height);
-    glActiveTexture(GL_TEXTURE0);
-
-    // Ping-pong at full resolution: m_sampleFramebuffer ↔ blurTempFramebuffer
-    for (int iteration = 0; iteration < iterations; iteration++) {
-        // Horizontal pass: m_sampleFramebuffer → blurTempFramebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, blurTempFramebuffer.getFBID());
-        m_sampleFramebuffer.getTexture()->bind();
-        glUniform2f(blurUniforms.direction, 1.0f / width, 0.0f);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
-
-        // Vertical pass: blurTempFramebuffer → m_sampleFramebuffer
-        glBindFramebuffer(GL_FRAMEBUFFER, m_sampleFramebuffer.getFBID());
-        blurTempFramebuffer.getTexture()->bind();
-        glUniform2f(blurUniforms.direction, 0.0f, 1.0f / height);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        g_pGlobalState->blurTempVram.set(framebufferBytes(blurTempFramebuffer));
+        g_pGlobalState->telemetry.countFramebufferRealloc();
+        glState.countAllocation();
+        glState.invalidateContext();
     }
 
+    const uint64_t pixelsBlurred = BlurPasses::render(sourceFramebuffer, m_sampleOrigin, m_sampleExtent, m_sampleFramebuffer, blurTempFramebuffer,
+                                                      sampleDamage, radius, m_sampleScale, iterations);
+
+    g_pGlobalState->telemetry.countPixelsBlurred(pixelsBlurred);
+    m_fusedBlur = {radius * m_sampleScale, Vector2D(0.0, 1.0 / height)};
+
     // Restore caller's GL state without querying (avoids pipeline stalls)
-    glBindFramebuffer(GL_FRAMEBUFFER, callerFramebufferID);
-    glBindVertexArray(0);
-    g_pHyprOpenGL->setViewport(0, 0, viewportWidth, viewportHeight);
+    glState.bindFramebuffer(GL_FRAMEBUFFER, callerFramebufferID);
+    glState.bindVertexArray(0);
+    glState.setViewport(0, 0, viewportWidth, viewportHeight);
 }
 
-void CGlassDecoration::uploadThemeUniforms(const SResolveContext& ctx) const {
-    const auto& uniforms = g_pGlobalState->shaderManager.glassUniforms;
-    const auto& glassShader = g_pGlobalState->shaderManager.glassShader;
-    const auto& defaults = ctx.isDark ? DARK_THEME_DEFAULTS : LIGHT_THEME_DEFAULTS;
+void CGlassDecoration::blurStochastic(CFramebuffer& sourceFramebuffer, const std::optional<SSampleState>& previousState, float radius,
+                                      int iterations, GLuint callerFramebufferID, int viewportWidth, int viewportHeight) {
+    TRACE_GPU_ZONE("blurStochastic");
+    const CTelemetryStageTimer stageTimer{Telemetry::STAGE_BLUR};
 
-    glassShader->setUniformFloat(SHADER_BRIGHTNESS, resolvePresetFloat(ctx, &SPresetValues::brightness, &SOverridableConfig::brightness, defaults.brightness));
-    glassShader->setUniformFloat(SHADER_CONTRAST,   resolvePresetFloat(ctx, &SPresetValues::contrast, &SOverridableConfig::contrast, defaults.contrast));
-    glUniform1f(uniforms.saturation,                 resolvePresetFloat(ctx, &SPresetValues::saturation, &SOverridableConfig::saturation, defaults.saturation));
-    glassShader->setUniformFloat(SHADER_VIBRANCY,   resolvePresetFloat(ctx, &SPresetValues::vibrancy, &SOverridableConfig::vibrancy, defaults.vibrancy));
-    glUniform1f(uniforms.vibrancyDarkness,           resolvePresetFloat(ctx, &SPresetValues::vibrancyDarkness, &SOverridableConfig::vibrancyDarkness, defaults.vibrancyDarkness));
+    const int width  = static_cast<int>(m_sampleFramebuffer.m_size.x);
+    const int height = static_cast<int>(m_sampleFramebuffer.m_size.y);
 
-    glUniform1f(uniforms.adaptiveDim,   resolvePresetFloat(ctx, &SPresetValues::adaptiveDim, &SOverridableConfig::adaptiveDim, defaults.adaptiveDim));
-    glUniform1f(uniforms.adaptiveBoost, resolvePresetFloat(ctx, &SPresetValues::adaptiveBoost, &SOverridableConfig::adaptiveBoost, defaults.adaptiveBoost));
+    // The estimate lands in the temp buffer while the sample serves as history
+    auto& glState             = g_pGlobalState->glState;
+    auto& blurTempFramebuffer = g_pGlobalState->blurTempFramebuffer;
+    if (blurTempFramebuffer.m_size.x != width || blurTempFramebuffer.m_size.y != height) {
+        blurTempFramebuffer.alloc(width, height, m_sampleFramebuffer.m_drmFormat);
+        g_pGlobalState->blurTempVram.set(framebufferBytes(blurTempFramebuffer));
+        g_pGlobalState->telemetry.countFramebufferRealloc();
+        glState.countAllocation();
+        glState.invalidateContext();
+    }
+
+    // The backdrop stays put on the monitor while the window moves over it:
+    // where the rects overlap, last frame's estimate is still right one move
+    // away. Only an estimate of the same kernel at the same resolution qualifies.
+    const bool reproject = previousState && previousState->stochastic && previousState->size == m_sampleFramebuffer.m_size &&
+        previousState->scale == m_sampleScale && previousState->blurRadius == radius && previousState->blurIterations == iterations;
+    m_stochasticFrames = reproject ? m_stochasticFrames + 1 : 0;
+
+    const float    historyWeight = std::min(1.0f - 1.0f / static_cast<float>(m_stochasticFrames + 1), 1.0f - STOCHASTIC_MIN_WEIGHT);
+    const Vector2D historyOffset = reproject ? (m_sampleOrigin - previousState->origin) * m_sampleScale : Vector2D();
+
+    const uint64_t pixelsBlurred = BlurPasses::stochastic(sourceFramebuffer, m_sampleOrigin, m_sampleExtent, blurTempFramebuffer, m_sampleFramebuffer,
+                                                          historyOffset, historyWeight, radius, m_sampleScale, iterations, m_stochasticFrames);
+
+    if (auto* capture = g_pGlobalState->capture.pendingPass()) {
+        const auto sigma              = BlurPasses::chainSigmaPx(radius, m_sampleScale, iterations);
+        capture->pass.stochasticSigma = {static_cast<float>(sigma.x), static_cast<float>(sigma.y)};
+        capture->pass.historyOffset   = {static_cast<float>(historyOffset.x), static_cast<float>(historyOffset.y)};
+        capture->pass.historyWeight   = historyWeight;
+        capture->pass.stochasticFrame = m_stochasticFrames;
+    }
+
+    const auto whole = CRegion(CBox{0.0, 0.0, m_sampleFramebuffer.m_size.x, m_sampleFramebuffer.m_size.y});
+    BlurPasses::copyShifted(blurTempFramebuffer, Vector2D(), m_sampleFramebuffer, whole);
+
+    g_pGlobalState->telemetry.countPixelsBlurred(pixelsBlurred);
+    m_fusedBlur = {};
+
+    glState.bindFramebuffer(GL_FRAMEBUFFER, callerFramebufferID);
+    glState.bindVertexArray(0);
+    glState.setViewport(0, 0, viewportWidth, viewportHeight);
 }
 
-void CGlassDecoration::applyGlassEffect(CFramebuffer& sourceFramebuffer, CFramebuffer& targetFramebuffer,
-                                         CBox& rawBox, CBox& transformedBox, float windowAlpha) {
-    const auto& config   = g_pGlobalState->config;
-    auto& shaderManager  = g_pGlobalState->shaderManager;
-    const auto& uniforms = shaderManager.glassUniforms;
+const CRegion& CGlassDecoration::cachedSampleDamage(const PHLWINDOW& window, const PHLMONITOR& monitor, const CFramebuffer& cache,
+                                                    const CRegion& sampleDamage, float radius, int iterations) {
+    // Special workspaces are drawn over the dimmed regular one
+    if (window->onSpecialWorkspace())
+        return m_cachedDamage.clear();
+
+    // Everything drawn between the layers and this pass: the windows below this
+    // one, with their decorations, and its own shadow and border. Gathered once
+    // for the frame by the backdrop cache.
+    const auto* entry = g_pGlobalState->decorations.get(m_handle);
+    if (!entry || !entry->coverFrame || entry->coverFrame != g_pGlobalState->backdropCache.coverFrame())
+        return m_cachedDamage.clear();
+
+    auto&      dynamic   = m_dynamicDamage.set(entry->coverBelow);
+    const auto transform = Math::wlTransformToHyprutils(Math::invertTransform(monitor->m_transform));
+    dynamic.transform(transform, monitor->m_transformedSize.x, monitor->m_transformedSize.y)
+        .translate(-m_sampleOrigin)
+        .scale(m_sampleScale)
+        .expand(GlassPasses::reachPx(radius, iterations) + 1.0);
+
+    const CBox cacheRect = {-std::round(m_sampleOrigin.x * m_sampleScale), -std::round(m_sampleOrigin.y * m_sampleScale), cache.m_size.x, cache.m_size.y};
+    return m_cachedDamage.set(sampleDamage).intersect(cacheRect).subtract(dynamic);
+}
 
-    const bool isDark          = resolveThemeIsDark();
-    const std::string preset   = resolvePresetName();
-    const SResolveContext ctx  = {preset, isDark, config, g_pGlobalState->customPresets};
+void CGlassDecoration::copyCachedBlur(CFramebuffer& cache, const CRegion& cachedDamage, GLuint callerFramebufferID) {
+    // Same intermediate as blurBackground() leaves, offset by where the sample sits on the monitor
+    const Vector2D offset = {std::round(m_sampleOrigin.x * m_sampleScale), std::round(m_sampleOrigin.y * m_sampleScale)};
+    BlurPasses::copyShifted(cache, offset, m_sampleFramebuffer, cachedDamage);
 
-    const auto transform = Math::wlTransformToHyprutils(
-        Math::invertTransform(g_pHyprOpenGL->m_renderData.pMonitor->m_transform));
+    g_pGlobalState->glState.bindFramebuffer(GL_FRAMEBUFFER, callerFramebufferID);
+}
 
-    Mat3x3 matrix   = g_pHyprOpenGL->m_renderData.monitorProjection.projectBox(rawBox, transform, rawBox.rot);
-    Mat3x3 glMatrix = g_pHyprOpenGL->m_renderData.projection.copy().multiply(matrix);
-    auto texture    = sourceFramebuffer.getTexture();
+void CGlassDecoration::measureBackdrop(CFramebuffer& sourceFramebuffer, const CBox& box, GLuint callerFramebufferID, int viewportWidth,
+                                       int viewportHeight) {
+    if (!m_backdropProbe.beginCapture())
+        return;
 
-    glMatrix.transpose();
+    auto& shaderManager = g_pGlobalState->shaderManager;
+    auto& glState       = g_pGlobalState->glState;
+
+    // beginCapture() may have allocated behind the state cache
+    glState.invalidateContext();
+
+    const double size  = CBackdropProbe::REDUCTION_SIZE;
+    const auto   whole = CRegion(CBox{0.0, 0.0, size, size});
+    const GLsync fence = GlassPasses::measure(g_pGlobalState->passContext, shaderManager.backdropStatsShader, shaderManager.backdropStatsUniforms,
+                                              BlurPasses::buffer(sourceFramebuffer), {box.x, box.y, box.width, box.height}, m_backdropProbe.target(),
+                                              whole);
+    m_backdropProbe.endCapture(fence);
 
-    glBindFramebuffer(GL_FRAMEBUFFER, targetFramebuffer.getFBID());
-    glActiveTexture(GL_TEXTURE0);
-    texture->bind();
+    glState.bindFramebuffer(GL_FRAMEBUFFER, callerFramebufferID);
+    glState.bindVertexArray(0);
+    glState.setViewport(0, 0, viewportWidth, viewportHeight);
+}
+
+// Farthest any composite pixel samples from its own position, in sample
+// pixels: edge refraction (blue channel) plus the dome lens, whose gradient
+// reaches 4 lens units per axis, plus the bilinear texel.
+static double computeSampleReachPx(const SPresetValues& params, double minDim) {
+    const double maxRefractionPx = params.refractionStrength * 50.0 * (1.0 + params.chromaticAberration * 0.35);
+    const double maxLensPx       = 4.0 * params.lensDistortion * minDim * 0.006;
+
+    return std::ceil(maxRefractionPx + maxLensPx) + 1.0;
+}
+
+// Outside the frame's damage the monitor framebuffer still holds last frame's
+// composite, this window's glass included. The sample is rebuilt from the
+// damage grown by the refraction reach and the blur passes: grow the frame's
+// damage by as much while the pass is still being built, so every layer below
+// is drawn there again before the glass reads it. Reach is taken at the lowest
+// sample resolution, the tier being picked in renderPass().
+void CGlassDecoration::growFrameDamage(const PHLWINDOW& window, const PHLMONITOR& monitor) {
+    auto&      frameDamage = g_pHyprOpenGL->m_renderData.damage;
+    const auto box         = WindowGeometry::computeWindowBox(window, monitor);
+    m_backdropRedrawn      = false;
+    if (!box) {
+        m_sourceDamage.clear();
+        return;
+    }
+
+    m_sourceDamage.set(frameDamage).intersect(box->copy().expand(SAMPLE_PADDING_PX));
+    if (m_sourceDamage.empty())
+        return;
+
+    const auto& params     = resolvePresetValues(resolvePresetId(), resolveThemeIsDark());
+    const float radius     = params.blurStrength * 12.0f;
+    const int   iterations = std::clamp(static_cast<int>(params.blurIterations), 1, 5);
+    const float scale      = LevelOfDetail::TIER_SETTINGS[LevelOfDetail::TIER_LOW].sampleScale;
+
+    double reach = computeSampleReachPx(params, std::min(box->width, box->height)) + 1.0;
+    if (radius > 0.0f)
+        reach += GlassPasses::sourceReachPx(radius, scale, iterations);
+
+    m_grownDamage.set(m_sourceDamage).expand(std::ceil(reach));
+    frameDamage.add(m_grownDamage);
+
+    // Damage only grows from here on
+    m_backdropRedrawn = m_grownDamage.set(*box).subtract(frameDamage).empty();
+}
+
+// Distance from the window edge past which the bezel terms of liquidglass.frag
+// no longer show. edgeProximity p decays as exp(sdf / bezelWidth), and the
+// interior shader drops every term it scales: the refraction offset and the
+// lens fade move the sample by at most p · maxRefractionPx and p · maxLensPx,
+// the fresnel, specular and inner shadow terms change the colour by at most
+// p² · rim. The inset is where the first two are under INTERIOR_MAX_OFFSET_PX
+// and the last under one 8-bit step, and past the rounded corners.
+static double computeInteriorInsetPx(const SPresetValues& params, const Vector2D& fullSize, float cornerRadius) {
+    const double minDim          = std::min(fullSize.x, fullSize.y);
+    const double bezelWidthPx    = params.edgeThickness * minDim;
+    const double maxRefractionPx = params.refractionStrength * 50.0 * (1.0 + params.chromaticAberration * 0.35);
+    const double maxLensPx       = 4.0 * params.lensDistortion * minDim * 0.006;
+    const double maxRim          = std::max({params.fresnelStrength * 0.15, params.specularStrength * 0.08, 0.06});
+
+    // Largest edge proximity the interior shader may leave out
+    double proximity = std::sqrt((1.0 / 255.0) / maxRim);
+    if (maxRefractionPx > 0.0)
+        proximity = std::min(proximity, CGlassDecoration::INTERIOR_MAX_OFFSET_PX / maxRefractionPx);
+    if (maxLensPx > 0.0)
+        proximity = std::min(proximity, CGlassDecoration::INTERIOR_MAX_OFFSET_PX / maxLensPx);
+
+    const double bezelWidths = proximity < 1.0 ? -std::log(proximity) : 0.0;
+
+    // The corner alpha reaches 1 once the SDF is under -1.5
+    return std::ceil(std::max<double>(cornerRadius + 1.5, bezelWidths * bezelWidthPx)) + 1.0;
+}
+
+void CGlassDecoration::applyGlassEffect(CFramebuffer& sourceFramebuffer, CFramebuffer& targetFramebuffer, const CRegion& damage,
+                                         CBox& rawBox, CBox& transformedBox, const SPresetValues& params, GLuint toneLut, float windowAlpha) {
+    TRACE_GPU_ZONE("applyGlassEffect");
+    const CTelemetryStageTimer stageTimer{Telemetry::STAGE_GLASS};
+
+    auto&       shaderManager = g_pGlobalState->shaderManager;
+    const auto& monitor       = g_pHyprOpenGL->m_renderData.pMonitor;
+
+    const auto transform = Math::wlTransformToHyprutils(Math::invertTransform(monitor->m_transform));
 
-    auto shader = g_pHyprOpenGL->useShader(shaderManager.glassShader);
+    Mat3x3 matrix   = g_pHyprOpenGL->m_renderData.monitorProjection.projectBox(rawBox, transform, rawBox.rot);
+    Mat3x3 glMatrix = g_pHyprOpenGL->m_renderData.projection.copy().multiply(matrix);
 
-    shader->setUniformMatrix3fv(SHADER_PROJ, 1, GL_FALSE, glMatrix.getMatrix());
-    shader->setUniformInt(SHADER_TEX, 0);
+    glMatrix.transpose();
 
     const auto fullSize = Vector2D(transformedBox.width, transformedBox.height);
-    shader->setUniformFloat2(SHADER_FULL_SIZE,
-        static_cast<float>(fullSize.x), static_cast<float>(fullSize.y));
-
-    glUniform1f(uniforms.refractionStrength,  resolvePresetFloat(ctx, &SPresetValues::refractionStrength, &SOverridableConfig::refractionStrength));
-    glUniform1f(uniforms.chromaticAberration, resolvePresetFloat(ctx, &SPresetValues::chromaticAberration, &SOverridableConfig::chromaticAberration));
-    glUniform1f(uniforms.fresnelStrength,     resolvePresetFloat(ctx, &SPresetValues::fresnelStrength, &SOverridableConfig::fresnelStrength));
-    glUniform1f(uniforms.specularStrength,    resolvePresetFloat(ctx, &SPresetValues::specularStrength, &SOverridableConfig::specularStrength));
-    glUniform1f(uniforms.glassOpacity,        resolvePresetFloat(ctx, &SPresetValues::glassOpacity, &SOverridableConfig::glassOpacity) * windowAlpha);
-    glUniform1f(uniforms.edgeThickness,       resolvePresetFloat(ctx, &SPresetValues::edgeThickness, &SOverridableConfig::edgeThickness));
-    glUniform1f(uniforms.lensDistortion,      resolvePresetFloat(ctx, &SPresetValues::lensDistortion, &SOverridableConfig::lensDistortion));
-
-    uploadThemeUniforms(ctx);
-
-    const int64_t tintColorValue = resolvePresetInt(ctx, &SPresetValues::tintColor, &SOverridableConfig::tintColor);
-    glUniform3f(uniforms.tintColor,
-        static_cast<float>((tintColorValue >> 24) & 0xFF) / 255.0f,
-        static_cast<float>((tintColorValue >> 16) & 0xFF) / 255.0f,
-        static_cast<float>((tintColorValue >> 8) & 0xFF) / 255.0f);
-    glUniform1f(uniforms.tintAlpha,
-        static_cast<float>(tintColorValue & 0xFF) / 255.0f);
-
-    glUniform2f(uniforms.uvPadding,
-        static_cast<float>(m_samplePaddingRatio.x),
-        static_cast<float>(m_samplePaddingRatio.y));
+    const double minDim = std::min(fullSize.x, fullSize.y);
 
     const auto window = m_window.lock();
-    float monitorScale = g_pHyprOpenGL->m_renderData.pMonitor->m_scale;
+    float monitorScale  = monitor->m_scale;
     float cornerRadius  = window ? window->rounding() * monitorScale : 0.0f;
     float roundingPower = window ? window->roundingPower() : 2.0f;
-    shader->setUniformFloat(SHADER_RADIUS, cornerRadius);
-    shader->setUniformFloat(SHADER_ROUNDING_POWER, roundingPower);
 
-    glBindVertexArray(shader->getUniformLocation(SHADER_SHADER_VAO));
-    g_pHyprOpenGL->scissor(rawBox);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    // The bezel ring gets the full refraction shader, the inset interior the
+    // tone-map-only one. The inset is symmetric, so it is the same in raw and
+    // transformed space.
+    const double inset         = computeInteriorInsetPx(params, fullSize, cornerRadius);
+    const bool   splitInterior = rawBox.width > 2.0 * inset && rawBox.height > 2.0 * inset;
+
+    // The edge field tile must reach past the corner radius and cover every
+    // pixel the full shader runs on: the bezel ring, or the whole window
+    const float clampedRadius = std::min(cornerRadius, static_cast<float>(minDim * 0.5));
+    const float bezelWidthPx  = static_cast<float>(params.edgeThickness * minDim);
+    const int   fieldSize     = static_cast<int>(std::min(std::ceil(std::max<double>(clampedRadius + 1.0, inset)),
+                                                          std::ceil(std::max(fullSize.x, fullSize.y) * 0.5) + 1.0));
+    if (m_edgeField.update(clampedRadius, roundingPower, bezelWidthPx, fieldSize))
+        g_pGlobalState->glState.invalidateTextures();
+
+    GlassPasses::SComposite composite;
+    composite.framebuffer    = targetFramebuffer.getFBID();
+    composite.viewportWidth  = static_cast<int>(monitor->m_transformedSize.x);
+    composite.viewportHeight = static_cast<int>(monitor->m_transformedSize.y);
+    std::memcpy(composite.projection.data(), &glMatrix.getMatrix()[0], sizeof(composite.projection));
+    composite.box                 = {rawBox.x, rawBox.y, rawBox.width, rawBox.height};
+    composite.fullSize            = {static_cast<float>(fullSize.x), static_cast<float>(fullSize.y)};
+    composite.interiorInset       = splitInterior ? inset : 0.0;
+    composite.sample              = sourceFramebuffer.getTexture()->m_texID;
+    composite.edgeField           = m_edgeField.texture();
+    composite.edgeFieldSize       = m_edgeField.size();
+    composite.toneLut             = toneLut;
+    composite.uvPadding           = {static_cast<float>(m_samplePaddingRatio.x), static_cast<float>(m_samplePaddingRatio.y)};
+    composite.fusedBlurRadius     = m_fusedBlur.radius;
+    composite.fusedBlurDirection  = {static_cast<float>(m_fusedBlur.direction.x), static_cast<float>(m_fusedBlur.direction.y)};
+    composite.refractionStrength  = params.refractionStrength;
+    composite.chromaticAberration = params.chromaticAberration;
+    composite.fresnelStrength     = params.fresnelStrength;
+    composite.specularStrength    = params.specularStrength;
+    composite.glassOpacity        = params.glassOpacity * windowAlpha;
+    composite.lensDistortion      = params.lensDistortion;
+
+    if (auto* capture = g_pGlobalState->capture.pendingPass())
+        captureComposite(capture->pass, composite, transformedBox, params, clampedRadius, roundingPower, bezelWidthPx);
+
+    GlassPasses::composite(g_pGlobalState->passContext, shaderManager.glassShader, shaderManager.glassUniforms, shaderManager.glassInteriorShader,
+                           shaderManager.glassInteriorUniforms, composite, damage);
     g_pHyprOpenGL->scissor(nullptr);
 }
 
-void CGlassDecoration::renderPass(PHLMONITOR monitor, const float& alpha) {
+void CGlassDecoration::renderPass(PHLMONITOR monitor, const float& alpha, const CRegion& damage) {
+    TRACE_CPU_ZONE("renderPass");
+
     auto& shaderManager = g_pGlobalState->shaderManager;
     shaderManager.initializeIfNeeded();
 
-    if (!shaderManager.isInitialized())
+    if (!shaderManager.isInitialized() || damage.empty())
         return;
 
+    g_pGlobalState->glState.beginRenderPass();
+
     const auto window = m_window.lock();
     if (!window)
         return;
@@ -303,22 +512,300 @@ void CGlassDecoration::renderPass(PHLMONITOR monitor, const float& alpha) {
         g_pHyprOpenGL->m_renderData.pMonitor->m_transformedSize.x,
         g_pHyprOpenGL->m_renderData.pMonitor->m_transformedSize.y);
 
-    sampleBackground(*source, transformBox);
+    // The backdrop probe serves the automatic theme and the uniform backdrop
+    // check. Collect the readbacks that have landed since the last pass (never
+    // waiting on one) before the theme is resolved.
+    const bool autoTheme = resolveThemeMode() == THEME_AUTO;
+    const bool wasDark   = m_backdropProbe.prefersDarkTheme();
+    if (m_backdropProbe.poll() && autoTheme && m_backdropProbe.prefersDarkTheme() != wasDark)
+        damageEntire();
+
+    // Level of detail caps blur iterations, shader features and sample resolution
+    auto*      entry    = g_pGlobalState->decorations.get(m_handle);
+    const auto lodTier  = LevelOfDetail::selectTier(window, monitor, entry ? entry->visibleFraction : 1.0);
+    const auto presetId = resolvePresetId();
+    const bool isDark   = resolveThemeIsDark();
+    auto       params   = resolvePresetValues(presetId, isDark);
+    LevelOfDetail::applyTier(lodTier, params);
+
+    const auto& uniformThreshold = g_pGlobalState->config.lod.uniformBackdropThreshold;
+    const float threshold        = uniformThreshold ? **uniformThreshold : 0.0f;
+    const bool  checkUniform     = threshold > 0.0f && params.blurStrength > 0.0f;
+    const bool  probeBackdrop    = autoTheme || checkUniform;
+    if (!probeBackdrop)
+        m_backdropProbe.release();
+
+    // Nothing for a blur to smooth out: composite the unblurred copy. Leaving
+    // needs twice the detail, so noise around the threshold does not toggle it.
+    bool uniformBackdrop = false;
+    if (checkUniform && m_backdropProbe.hasReading())
+        uniformBackdrop = m_backdropProbe.detail() < (m_uniformBackdrop ? 2.0f * threshold : threshold);
+    if (uniformBackdrop != m_uniformBackdrop) {
+        m_uniformBackdrop = uniformBackdrop;
+        damageEntire();
+    }
+    if (m_uniformBackdrop)
+        params.blurStrength = 0.0f;
 
-    {
-        const auto& config         = g_pGlobalState->config;
-        const bool isDark          = resolveThemeIsDark();
-        const std::string preset   = resolvePresetName();
-        const SResolveContext ctx  = {preset, isDark, config, g_pGlobalState->customPresets};
+    // Only the damage is redrawn this frame: repaint the rest with the new tier next frame
+    if (lodTier != m_lodTier) {
+        m_lodTier = lodTier;
+        damageEntire();
+    }
 
-        float blurRadius     = resolvePresetFloat(ctx, &SPresetValues::blurStrength, &SOverridableConfig::blurStrength) * 12.0f;
-        int blurIterations   = std::clamp(static_cast<int>(resolvePresetInt(ctx, &SPresetValues::blurIterations, &SOverridableConfig::blurIterations)), 1, 5);
+    const float blurRadius     = params.blurStrength * 12.0f;
+    const int   blurIterations = std::clamp(static_cast<int>(params.blurIterations), 1, 5);
+    const float sampleScale    = LevelOfDetail::TIER_SETTINGS[lodTier].sampleScale;
+
+    // Interactive resize: every new size would reallocate the sample and blur
+    // all of it. The composite maps the sample onto the window box, so the last
+    // one is stretched over the new box instead, blurred again every
+    // RESIZE_STRETCH_FRAMES frames and on the frame after the size settles.
+    const Vector2D boxSize  = Vector2D(transformBox.width, transformBox.height);
+    const bool     resizing = boxSize != m_lastBoxSize;
+    const bool     stretch  = resizing && m_sampleState && m_sampleFramebuffer.isAllocated() && m_stretchedFrames < RESIZE_STRETCH_FRAMES &&
+        m_sampleState->scale == sampleScale && m_sampleState->blurRadius == blurRadius && m_sampleState->blurIterations == blurIterations;
+    m_lastBoxSize     = boxSize;
+    m_stretchedFrames = stretch ? m_stretchedFrames + 1 : 0;
+    if (stretch)
+        damageEntire();
+
+    if (entry)
+        entry->lastRenderedAt = std::chrono::steady_clock::now();
+    if (!stretch)
+        prepareSampleFramebuffer(*source, transformBox, sampleScale);
+    g_pGlobalState->vram.enforceBudget(this);
+    g_pGlobalState->vram.releaseIdle(this);
+    g_pGlobalState->telemetry.countWindowDrawn(monitor->m_id);
+
+    // Workspace slide: everything on the workspace moves along with the window,
+    // so its backdrop is taken as moving along too. Samples are keyed by where
+    // the window sits on its workspace: one taken at rest, or as the slide
+    // began, is composited wherever the window is now, untouched until the
+    // slide ends and the sample taken mid-slide no longer matches.
+    const bool sliding    = workspace && !window->m_pinned && workspaceOffset != Vector2D();
+    Vector2D   restOrigin = m_sampleOrigin;
+    if (sliding) {
+        CBox restBox = window->getWindowMainSurfaceBox()
+                           .translate(-monitor->m_position + window->m_floatingOffset)
+                           .scale(monitor->m_scale)
+                           .round();
+        restBox.transform(transform, monitor->m_transformedSize.x, monitor->m_transformedSize.y);
+        restOrigin = Vector2D(restBox.x - SAMPLE_PADDING_PX, restBox.y - SAMPLE_PADDING_PX);
+    }
+
+    // While the window moves, the whole rect is blurred again every frame. With
+    // stochastic_blur, a big kernel is estimated in one pass instead, averaged
+    // over the frames of the move; the exact blur takes over once it stops.
+    const auto& stochasticBlur = g_pGlobalState->config.lod.stochasticBlur;
+    const bool  boxChanged     = m_sampleState && (m_sampleState->origin != restOrigin || m_sampleState->size != m_sampleFramebuffer.m_size);
+    const bool  stochastic     = stochasticBlur && **stochasticBlur && blurRadius > 0.0f && blurIterations >= STOCHASTIC_MIN_ITERATIONS && boxChanged && !sliding;
+
+    // The offscreen passes work in padded sample pixels. Outside the damage
+    // (grown by how far the composite samples) m_sampleFramebuffer still holds
+    // last frame's result, as long as it was computed for the same rect and kernel.
+    const CBox         sampleRect    = {0.0, 0.0, m_sampleFramebuffer.m_size.x, m_sampleFramebuffer.m_size.y};
+    const SSampleState sampleState   = {restOrigin, m_sampleFramebuffer.m_size, m_sampleScale, blurRadius, blurIterations, stochastic, sliding};
+    const auto         previousState = m_sampleState;
+
+    bool slideReuse = false;
+    if (sliding && m_sampleState) {
+        auto keyed       = *m_sampleState;
+        keyed.slideTaken = true;
+        slideReuse       = keyed == sampleState;
+    }
+
+    const bool steadyState = stretch || slideReuse || m_sampleState == sampleState;
+
+    // Fading in or out with nothing else changing: only the alpha of the
+    // composite moves. The backdrop is on hold until the fade is over.
+    const bool fading    = window->m_alpha->isBeingAnimated() || window->m_activeInactiveAlpha->isBeingAnimated();
+    const bool fadeReuse = fading && steadyState;
+    if (fadeReuse)
+        m_fadeHeldBackdrop = true;
+    else if (m_fadeHeldBackdrop && !fading) {
+        m_fadeHeldBackdrop = false;
+        damageEntire();
+    }
+
+    const bool reuseSample  = stretch || slideReuse || fadeReuse;
+    auto&      sampleDamage = m_sampleDamage.set(sampleRect);
+    if (reuseSample) {
+        g_pGlobalState->telemetry.countSampleReuse();
+        sampleDamage.clear();
+    } else if (steadyState) {
+        g_pGlobalState->telemetry.countSampleReuse();
+        const double minDim = std::min(transformBox.width, transformBox.height);
+        sampleDamage.set(m_sourceDamage)
+                    .transform(transform, monitor->m_transformedSize.x, monitor->m_transformedSize.y)
+                    .translate(-m_sampleOrigin)
+                    .scale(m_sampleScale)
+                    .expand(computeSampleReachPx(params, minDim) * m_sampleScale + 1.0)
+                    .intersect(sampleRect);
+    }
+    if (!reuseSample)
+        m_sampleState = sampleState;
+
+    // backdrop_fps: the backdrop is sampled again at most that often. Until
+    // then the composite reuses the sample and the damage is held back, with
+    // a wake-up in case no other frame comes. Anything but steady state, the
+    // window moving included, refreshes at once.
+    const auto now = std::chrono::steady_clock::now();
+    if (!steadyState) {
+        m_deferredSampleDamage.clear();
+        m_deferredDamage.clear();
+    } else if (!reuseSample)
+        sampleDamage.add(m_deferredSampleDamage);
+
+    if (steadyState && !sampleDamage.empty()) {
+        if (params.backdropFps > 0 && now < m_nextBackdropRefresh) {
+            const CBox paddedBox = windowBox.copy().expand(SAMPLE_PADDING_PX);
+            m_deferredDamage.add(m_grownDamage.set(m_sourceDamage).intersect(paddedBox).scale(1.0 / monitor->m_scale).translate(monitor->m_position));
+            m_deferredSampleDamage.set(sampleDamage);
+            sampleDamage.clear();
+            g_pGlobalState->refreshScheduler.schedule(m_self, m_nextBackdropRefresh);
+        } else {
+            m_deferredSampleDamage.clear();
+            m_deferredDamage.clear();
+        }
+    }
+    if (!sampleDamage.empty() && params.backdropFps > 0)
+        m_nextBackdropRefresh = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / params.backdropFps));
+
+    auto* capture = beginCapture(monitor, *source, damage, lodTier, blurRadius, blurIterations, steadyState);
+
+    {
         int viewportWidth    = static_cast<int>(g_pHyprOpenGL->m_renderData.pMonitor->m_transformedSize.x);
         int viewportHeight   = static_cast<int>(g_pHyprOpenGL->m_renderData.pMonitor->m_transformedSize.y);
-        blurBackground(blurRadius, blurIterations, source->getFBID(), viewportWidth, viewportHeight);
+
+        // Measured on the unblurred source for a later frame: the blur would hide
+        // the detail. Only where the whole box was drawn again this frame: outside
+        // the damage the source still holds last frame's composite, this window's
+        // glass and content included.
+        if (probeBackdrop && m_backdropRedrawn && now >= m_nextBackdropProbe) {
+            measureBackdrop(*source, transformBox, source->getFBID(), viewportWidth, viewportHeight);
+            m_nextBackdropProbe = now + PROBE_INTERVAL;
+        }
+
+        // Blurring samples the source directly; only an unblurred preset needs the copy.
+        // Out of reach of any window, the blurred layers come from the backdrop cache,
+        // copied last over whatever the blur passes spilled around their region.
+        if (reuseSample) {
+            // Nothing to sample: the fused pass stays as the sample was left
+        } else if (stochastic) {
+            if (capture)
+                capture->pass.path = Capture::PATH_STOCHASTIC;
+            blurStochastic(*source, previousState, blurRadius, blurIterations, source->getFBID(), viewportWidth, viewportHeight);
+            // Draw once more after the last move, with the exact blur
+            damageEntire();
+        } else if (blurRadius > 0.0f) {
+            const CBackdropCache::SKernel kernel = {blurRadius, blurIterations, m_sampleScale};
+
+            auto& blurDamage   = m_blurDamage.set(sampleDamage);
+            auto& cachedDamage = m_cachedDamage.clear();
+            auto* cache        = sampleDamage.empty() ? nullptr : g_pGlobalState->backdropCache.blurred(monitor, kernel, !steadyState);
+            if (cache)
+                blurDamage.subtract(cachedSampleDamage(window, monitor, *cache, sampleDamage, blurRadius, blurIterations));
+
+            blurBackground(*source, blurDamage, blurRadius, blurIterations, source->getFBID(), viewportWidth, viewportHeight);
+            if (!cachedDamage.empty())
+                copyCachedBlur(*cache, cachedDamage, source->getFBID());
+
+            if (capture) {
+                capture->pass.path = Capture::PATH_BLUR;
+                CCaptureRecorder::appendRects(capture->blurred, blurDamage);
+                CCaptureRecorder::appendRects(capture->cached, cachedDamage);
+            }
+        } else {
+            sampleBackground(*source, sampleDamage);
+
+            if (capture) {
+                capture->pass.path = Capture::PATH_COPY;
+                CCaptureRecorder::appendRects(capture->blurred, sampleDamage);
+            }
+        }
     }
 
-    applyGlassEffect(m_sampleFramebuffer, *source, windowBox, transformBox, alpha);
+    const GLuint toneLut = g_pGlobalState->toneLuts.texture(presetId, isDark, params);
+    applyGlassEffect(m_sampleFramebuffer, *source, damage, windowBox, transformBox, params, toneLut, alpha);
+    g_pGlobalState->capture.endPass();
+    g_pGlobalState->glState.endRenderPass(steadyState);
+}
+
+size_t CGlassDecoration::evictableBytes() const noexcept {
+    return m_sampleVram.bytes() + m_edgeField.vramBytes() + m_backdropProbe.vramBytes();
+}
+
+void CGlassDecoration::evictBuffers() {
+    m_sampleFramebuffer.release();
+    m_sampleVram.set(0);
+    m_sampleState.reset();
+    m_edgeField.release();
+    m_backdropProbe.release(); // keeps its last reading
+
+    // Names of the deleted objects may be handed out again
+    g_pGlobalState->glState.invalidateContext();
+}
+
+// ── Capture ──────────────────────────────────────────────────────────────────
+
+CCaptureRecorder::SPendingPass* CGlassDecoration::beginCapture(const PHLMONITOR& monitor, CFramebuffer& sourceFramebuffer, const CRegion& damage,
+                                                               LevelOfDetail::eTier lodTier, float blurRadius, int blurIterations, bool steadyState) {
+    auto* capture = g_pGlobalState->capture.beginPass();
+    if (!capture)
+        return nullptr;
+
+    auto& pass             = capture->pass;
+    pass.windowId          = (static_cast<uint64_t>(m_handle.index) << 32) | m_handle.generation;
+    pass.monitorId         = monitor->m_id;
+    pass.monitorTransform  = static_cast<int32_t>(monitor->m_transform);
+    pass.monitorScale      = monitor->m_scale;
+    pass.framebufferWidth  = static_cast<uint32_t>(sourceFramebuffer.m_size.x);
+    pass.framebufferHeight = static_cast<uint32_t>(sourceFramebuffer.m_size.y);
+    pass.sampleOrigin      = {static_cast<float>(m_sampleOrigin.x), static_cast<float>(m_sampleOrigin.y)};
+    pass.sampleExtent      = {static_cast<float>(m_sampleExtent.x), static_cast<float>(m_sampleExtent.y)};
+    pass.sampleWidth       = static_cast<uint32_t>(m_sampleFramebuffer.m_size.x);
+    pass.sampleHeight      = static_cast<uint32_t>(m_sampleFramebuffer.m_size.y);
+    pass.sampleScale       = m_sampleScale;
+    pass.path              = Capture::PATH_REUSE;
+    pass.lodTier           = static_cast<uint8_t>(lodTier);
+    pass.steadyState       = steadyState ? 1 : 0;
+    pass.blurRadius        = blurRadius;
+    pass.blurIterations    = blurIterations;
+
+    // Framebuffer pixels, like the sample rect
+    const auto transform = Math::wlTransformToHyprutils(Math::invertTransform(monitor->m_transform));
+    CCaptureRecorder::appendRects(capture->damage, damage.copy().transform(transform, monitor->m_transformedSize.x, monitor->m_transformedSize.y));
+
+    g_pGlobalState->capture.captureBackdrop(sourceFramebuffer, m_sampleOrigin, m_sampleExtent);
+    return capture;
+}
+
+void CGlassDecoration::captureComposite(Capture::SPass& pass, const GlassPasses::SComposite& composite, const CBox& transformedBox,
+                                        const SPresetValues& params, float cornerRadius, float roundingPower, float bezelWidthPx) const {
+    pass.projection          = composite.projection;
+    pass.box                 = {static_cast<float>(transformedBox.x), static_cast<float>(transformedBox.y), static_cast<float>(transformedBox.width),
+                                static_cast<float>(transformedBox.height)};
+    pass.interiorInset       = static_cast<float>(composite.interiorInset);
+    pass.fusedBlurRadius     = composite.fusedBlurRadius;
+    pass.fusedBlurDirection  = composite.fusedBlurDirection;
+    pass.uvPadding           = composite.uvPadding;
+    pass.refractionStrength  = composite.refractionStrength;
+    pass.chromaticAberration = composite.chromaticAberration;
+    pass.fresnelStrength     = composite.fresnelStrength;
+    pass.specularStrength    = composite.specularStrength;
+    pass.glassOpacity        = composite.glassOpacity;
+    pass.lensDistortion      = composite.lensDistortion;
+    pass.edgeCornerRadius    = cornerRadius;
+    pass.edgeRoundingPower   = roundingPower;
+    pass.edgeBezelWidthPx    = bezelWidthPx;
+    pass.edgeFieldSize       = composite.edgeFieldSize;
+    pass.tone                = CToneLuts::toneOf(params);
+}
+
+void CGlassDecoration::refreshDeferredBackdrop() {
+    for (const auto& rect : BlurPasses::rects(m_deferredDamage))
+        g_pHyprRenderer->damageBox(CBox(rect.x1, rect.y1, rect.x2 - rect.x1, rect.y2 - rect.y1));
 }
 
 eDecorationType CGlassDecoration::getDecorationType() {
@@ -330,6 +817,8 @@ void CGlassDecoration::updateWindow(PHLWINDOW window) {
 }
 
 void CGlassDecoration::damageEntire() {
+    TRACE_CPU_ZONE("damageEntire");
+
     const auto window = m_window.lock();
     if (!window)
         return;
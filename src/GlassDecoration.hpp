@@ -1,10 +1,22 @@
 #pragma once
 
+#include "BackdropProbe.hpp"
+#include "Capture.hpp"
+#include "DecorationRegistry.hpp"
+#include "EdgeField.hpp"
+#include "GlassPasses.hpp"
+#include "LevelOfDetail.hpp"
 #include "PluginConfig.hpp"
+#include "ShaderManager.hpp"
+#include "VramTracker.hpp"
 
 #include <hyprland/src/desktop/view/Window.hpp>
 #include <hyprland/src/render/decorations/IHyprWindowDecoration.hpp>
 #include <hyprland/src/render/Framebuffer.hpp>
+#include <hyprutils/math/Region.hpp>
+
+#include <chrono>
+#include <optional>
 
 class CGlassDecoration : public IHyprWindowDecoration {
   public:
@@ -22,30 +34,141 @@ class CGlassDecoration : public IHyprWindowDecoration {
     [[nodiscard]] std::string                getDisplayName() override;
 
     [[nodiscard]] PHLWINDOW getOwner();
-    void                    renderPass(PHLMONITOR monitor, const float& alpha);
+    void                    renderPass(PHLMONITOR monitor, const float& alpha, const CRegion& damage);
+
+    // VRAM budget: what evictBuffers() frees, reallocated on the next render pass
+    [[nodiscard]] size_t evictableBytes() const noexcept;
+    void                 evictBuffers();
+
+    // Damages what a put-off backdrop refresh (backdrop_fps) still has to redraw
+    void refreshDeferredBackdrop();
 
-    WP<CGlassDecoration> m_self;
+    WP<CGlassDecoration>         m_self;
+    CDecorationRegistry::SHandle m_handle; // entry in g_pGlobalState->decorations
 
     static constexpr int SAMPLE_PADDING_PX = 60;
 
+    // Most the cheap interior shader may move a sample against the bezel shader, in pixels
+    static constexpr double INTERIOR_MAX_OFFSET_PX = 0.25;
+
+    // Stochastic blur (stochastic_blur): kernels of at least this many
+    // iterations are estimated in one pass while the window moves
+    static constexpr int   STOCHASTIC_MIN_ITERATIONS = 3;
+    // Least weight of each new estimate against the accumulated ones, so what
+    // moved along with the window fades out of the history within a few frames
+    static constexpr float STOCHASTIC_MIN_WEIGHT = 0.25f;
+
+    // Frames in a row an interactive resize may stretch the last sample
+    static constexpr int RESIZE_STRETCH_FRAMES = 4;
+
+    // Least time between two backdrop probe readings
+    static constexpr std::chrono::milliseconds PROBE_INTERVAL{250};
+
   private:
     PHLWINDOWREF m_window;
-    CFramebuffer m_sampleFramebuffer;
-    Vector2D     m_samplePaddingRatio;
+    CFramebuffer      m_sampleFramebuffer;
+    CVramAllocation   m_sampleVram{VRAM_SAMPLE};
+    Vector2D          m_sampleOrigin; // bottom-left of the padded rect in source pixels (may be off-screen)
+    Vector2D          m_sampleExtent; // size of the padded rect in source pixels
+    float             m_sampleScale = 1.0f; // sample pixels per source pixel (level of detail)
+    Vector2D          m_samplePaddingRatio;
+    CEdgeFieldTexture m_edgeField;
+
+    // Final vertical blur pass left to the glass shader (radius 0: texture is final)
+    struct SFusedBlur {
+        float    radius = 0.0f;
+        Vector2D direction;
+    } m_fusedBlur;
+
+    // What m_sampleFramebuffer was last computed for. While it matches, only
+    // the damaged part of the sample is refreshed; otherwise the whole rect.
+    struct SSampleState {
+        Vector2D origin;
+        Vector2D size;
+        float    scale          = 1.0f;
+        float    blurRadius     = 0.0f;
+        int      blurIterations = 0;
+        bool     stochastic     = false; // final estimate, nothing left for the glass shader
+        bool     slideTaken     = false; // during a workspace slide: the backdrop was elsewhere
+
+        bool     operator==(const SSampleState&) const = default;
+    };
+    std::optional<SSampleState> m_sampleState;
+    // Estimates accumulated in a stochastic sample since its history was last reset
+    uint32_t                    m_stochasticFrames = 0;
+
+    // backdrop_fps: damage whose sampling was put off until m_nextBackdropRefresh,
+    // in sample pixels and in layout coordinates for the wake-up
+    CRegion                               m_deferredSampleDamage;
+    CRegion                               m_deferredDamage;
+    std::chrono::steady_clock::time_point m_nextBackdropRefresh;
+
+    // This frame's damage over the padded rect before growFrameDamage() grew it
+    // (monitor pixels): where the backdrop changed. m_grownDamage is scratch.
+    CRegion m_sourceDamage;
+    CRegion m_grownDamage;
+
+    // renderPass() scratch, kept for its storage: the damage to sample, the
+    // part of it blurred and the part copied from the backdrop cache (sample
+    // pixels), and what is drawn over the cache
+    CRegion m_sampleDamage;
+    CRegion m_blurDamage;
+    CRegion m_cachedDamage;
+    CRegion m_dynamicDamage;
+
+    // Window box size at the last pass (transformed monitor pixels), and the
+    // frames the sample has been stretched over a resizing box since last blurred
+    Vector2D m_lastBoxSize;
+    int      m_stretchedFrames = 0;
+    // A fade reused the sample: sample it all again once the fade is over
+    bool     m_fadeHeldBackdrop = false;
+
+    LevelOfDetail::eTier m_lodTier = LevelOfDetail::TIER_HIGH;
+
+    // Backdrop statistics for the automatic theme and the uniform backdrop
+    // check, only allocated while one of them is in use
+    CBackdropProbe m_backdropProbe;
+    // Last reading had no detail worth blurring (with hysteresis)
+    bool           m_uniformBackdrop = false;
+    // Every pixel of the window box is drawn again below it this frame, so the
+    // probe sees the backdrop rather than last frame's composite
+    bool                                  m_backdropRedrawn = false;
+    std::chrono::steady_clock::time_point m_nextBackdropProbe;
 
     // Track last rendered position/size to detect actual changes and seed damage
     Vector2D m_lastPosition;
     Vector2D m_lastSize;
 
-    [[nodiscard]] bool        resolveThemeIsDark() const;
-    [[nodiscard]] std::string resolvePresetName() const;
+    [[nodiscard]] eThemeMode resolveThemeMode() const;
+    [[nodiscard]] bool       resolveThemeIsDark() const;
+    [[nodiscard]] PresetId   resolvePresetId() const;
+
+    // Whether any pixel of the window's glass can end up on screen
+    [[nodiscard]] bool glassCanShow(const PHLWINDOW& window) const;
+    // Grows the frame's damage by how far the sample reads around it
+    void growFrameDamage(const PHLWINDOW& window, const PHLMONITOR& monitor);
+
+    void prepareSampleFramebuffer(CFramebuffer& sourceFramebuffer, const CBox& box, float sampleScale);
+    void sampleBackground(CFramebuffer& sourceFramebuffer, const CRegion& sampleDamage);
+    void blurBackground(CFramebuffer& sourceFramebuffer, const CRegion& sampleDamage, float radius, int iterations,
+                        GLuint callerFramebufferID, int viewportWidth, int viewportHeight);
+    void blurStochastic(CFramebuffer& sourceFramebuffer, const std::optional<SSampleState>& previousState, float radius, int iterations,
+                        GLuint callerFramebufferID, int viewportWidth, int viewportHeight);
+    // Into m_cachedDamage
+    const CRegion&        cachedSampleDamage(const PHLWINDOW& window, const PHLMONITOR& monitor, const CFramebuffer& cache, const CRegion& sampleDamage,
+                                             float radius, int iterations);
+    void                  copyCachedBlur(CFramebuffer& cache, const CRegion& cachedDamage, GLuint callerFramebufferID);
+    void measureBackdrop(CFramebuffer& sourceFramebuffer, const CBox& box, GLuint callerFramebufferID, int viewportWidth,
+                         int viewportHeight);
 
-    void sampleBackground(CFramebuffer& sourceFramebuffer, CBox box);
-    void blurBackground(float radius, int iterations, GLuint callerFramebufferID, int viewportWidth, int viewportHeight);
+    void applyGlassEffect(CFramebuffer& sourceFramebuffer, CFramebuffer& targetFramebuffer, const CRegion& damage,
+                          CBox& rawBox, CBox& transformedBox, const SPresetValues& params, GLuint toneLut, float windowAlpha);
 
-    void applyGlassEffect(CFramebuffer& sourceFramebuffer, CFramebuffer& targetFramebuffer,
-                          CBox& rawBox, CBox& transformedBox, float windowAlpha);
-    void uploadThemeUniforms(const SResolveContext& resolveContext) const;
+    // hyprctl hyprglass capture: the pass being recorded, nullptr unless capturing
+    [[nodiscard]] CCaptureRecorder::SPendingPass* beginCapture(const PHLMONITOR& monitor, CFramebuffer& sourceFramebuffer, const CRegion& damage,
+                                                               LevelOfDetail::eTier lodTier, float blurRadius, int blurIterations, bool steadyState);
+    void captureComposite(Capture::SPass& pass, const GlassPasses::SComposite& composite, const CBox& transformedBox, const SPresetValues& params,
+                          float cornerRadius, float roundingPower, float bezelWidthPx) const;
 
     friend class CGlassPassElement;
 };
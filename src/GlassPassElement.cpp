@@ -4,6 +4,57 @@
 #include "WindowGeometry.hpp"
 
 #include <hyprland/src/render/OpenGL.hpp>
+#include <new>
+
+// ── Block pool ───────────────────────────────────────────────────────────────
+
+namespace {
+
+struct SFreeBlock {
+    SFreeBlock* next = nullptr;
+};
+
+// More blocks than glass windows drawn in one frame go back to the heap
+constexpr size_t MAX_FREE_BLOCKS = 64;
+
+SFreeBlock* s_freeBlocks     = nullptr;
+size_t      s_freeBlockCount = 0;
+
+} // namespace
+
+void* CGlassPassElement::operator new(size_t size) {
+    if (size != sizeof(CGlassPassElement) || !s_freeBlocks)
+        return ::operator new(size);
+
+    auto* block  = s_freeBlocks;
+    s_freeBlocks = block->next;
+    s_freeBlockCount--;
+    return block;
+}
+
+void CGlassPassElement::operator delete(void* block, size_t size) noexcept {
+    if (!block)
+        return;
+
+    if (size != sizeof(CGlassPassElement) || s_freeBlockCount >= MAX_FREE_BLOCKS) {
+        ::operator delete(block);
+        return;
+    }
+
+    s_freeBlocks = new (block) SFreeBlock{s_freeBlocks};
+    s_freeBlockCount++;
+}
+
+void CGlassPassElement::releasePool() noexcept {
+    while (s_freeBlocks) {
+        auto* block  = s_freeBlocks;
+        s_freeBlocks = block->next;
+        ::operator delete(block);
+    }
+    s_freeBlockCount = 0;
+}
+
+// ── Pass element ─────────────────────────────────────────────────────────────
 
 CGlassPassElement::CGlassPassElement(const SGlassPassData& data)
     : m_data(data) {}
@@ -12,7 +63,9 @@ void CGlassPassElement::draw(const CRegion& damage) {
     if (!m_data.decoration)
         return;
 
-    m_data.decoration->renderPass(g_pHyprOpenGL->m_renderData.pMonitor.lock(), m_data.alpha);
+    // Hyprland and other plugins drew since any of our elements last ran
+    g_pGlobalState->glState.invalidateContext();
+    m_data.decoration->renderPass(g_pHyprOpenGL->m_renderData.pMonitor.lock(), m_data.alpha, damage);
 }
 
 std::optional<CBox> CGlassPassElement::boundingBox() {
@@ -4,6 +4,8 @@
 #include <hyprutils/math/Box.hpp>
 #include <hyprutils/math/Region.hpp>
 
+#include <cstddef>
+
 class CGlassDecoration;
 
 class CGlassPassElement : public IPassElement {
@@ -24,6 +26,14 @@ class CGlassPassElement : public IPassElement {
 
     [[nodiscard]] const char* passName() override { return "CGlassPassElement"; }
 
+    // Every glass window queues one per frame and the pass frees them after
+    // drawing: the blocks are recycled instead of going back to the heap.
+    // makeUnique's control block and the pass's own wrapper still are not.
+    static void* operator new(size_t size);
+    static void  operator delete(void* block, size_t size) noexcept;
+    // Frees the recycled blocks (plugin unload, once no element is queued)
+    static void releasePool() noexcept;
+
   private:
     SGlassPassData m_data;
 };
@@ -0,0 +1,490 @@
+#pragma once
+
+#include <GLES3/gl32.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// GL side of the blur passes and of the glass composite. No Hyprland
+// dependency: shared by the plugin and tools/hyprglass-replay, so a replay
+// issues the same passes over the same regions with the same uniforms.
+//
+// Every GL call goes through a context, gl, which provides:
+//   useProgram(program, projection)       makes it current with its quad VAO,
+//                                         uploads proj and tex = unit 0
+//   bindFramebuffer(target, framebuffer)
+//   bindTexture(unit, texture, target)    leaves unit 0 active when unit is 0
+//   setViewport(x, y, width, height)
+//   uniform1i / 1f / 2f / 4f(location, ...)
+//   drawGrown(region, grow, width, height)   the quad over the region grown
+//                                         by grow, within [0, width] × [0, height]
+//   drawClipped(region, x, y, width, height) the quad over the box's overlap
+//                                         with the region
+//   blit(region, source, target, filter)  the read framebuffer's source rect
+//                                         (x0, y0, x1, y1) onto the draw
+//                                         framebuffer's target rect, once per
+//                                         rect of the region under its scissor
+//   generateMipmap(target)                of the texture bound to unit 0
+//   readPixels(buffer, x, y, width, height) RGBA float texels of the read
+//                                         framebuffer, queued into a pixel
+//                                         pack buffer
+//   fenceSync() / fenceSignaled(fence) / deleteSync(fence)
+//                                         fenceSignaled() polls, never waits
+//   mapBuffer(buffer, bytes) / unmapBuffer() reads a pixel pack buffer
+// The draws and blits return the pixels they covered. The plugin routes it all through
+// CGLStateCache and Hyprland's scissor, the replay straight to GL, and the
+// tests (HYPRGLASS_GL_RECORD, not linked against GL) into a recording.
+namespace GlassPasses {
+
+// Fullscreen quad projection: maps VAO positions [0,1] to clip space [-1,1]
+inline constexpr std::array<float, 9> FULLSCREEN_PROJECTION = {
+    2.0f, 0.0f, 0.0f,
+    0.0f, 2.0f, 0.0f,
+   -1.0f,-1.0f, 1.0f,
+};
+
+// A framebuffer and its colour texture
+struct SBuffer {
+    GLuint framebuffer = 0;
+    GLuint texture     = 0;
+    int    width       = 0;
+    int    height      = 0;
+};
+
+struct SBlurUniforms {
+    GLint direction    = -1;
+    GLint radius       = -1;
+    GLint sourceOffset = -1;
+    GLint sourceScale  = -1;
+    GLint sourceClamp  = -1;
+};
+
+struct SStochasticBlurUniforms {
+    GLint history       = -1;
+    GLint sourceOffset  = -1;
+    GLint sourceScale   = -1;
+    GLint sourceClamp   = -1;
+    GLint sigma         = -1;
+    GLint frame         = -1;
+    GLint historyOffset = -1;
+    GLint historyWeight = -1;
+};
+
+struct SGlassUniforms {
+    GLint fullSize = -1;
+    GLint refractionStrength = -1;
+    GLint chromaticAberration = -1;
+    GLint fresnelStrength = -1;
+    GLint specularStrength = -1;
+    GLint glassOpacity = -1;
+    GLint edgeField = -1;
+    GLint edgeFieldSize = -1;
+    GLint uvPadding = -1;
+    GLint lensDistortion = -1;
+    GLint toneLut = -1;
+    GLint blurRadius = -1;
+    GLint blurDirection = -1;
+};
+
+struct SBackdropStatsUniforms {
+    GLint sourceOffset = -1;
+    GLint sourceScale  = -1;
+    GLint sourceClamp  = -1;
+    GLint footprint    = -1;
+};
+
+// The recording build has no GL to ask
+#ifndef HYPRGLASS_GL_RECORD
+inline void queryUniforms(GLuint program, SBlurUniforms& uniforms) {
+    uniforms.direction    = glGetUniformLocation(program, "direction");
+    uniforms.radius       = glGetUniformLocation(program, "blurRadius");
+    uniforms.sourceOffset = glGetUniformLocation(program, "sourceOffset");
+    uniforms.sourceScale  = glGetUniformLocation(program, "sourceScale");
+    uniforms.sourceClamp  = glGetUniformLocation(program, "sourceClamp");
+}
+
+inline void queryUniforms(GLuint program, SStochasticBlurUniforms& uniforms) {
+    uniforms.history       = glGetUniformLocation(program, "history");
+    uniforms.sourceOffset  = glGetUniformLocation(program, "sourceOffset");
+    uniforms.sourceScale   = glGetUniformLocation(program, "sourceScale");
+    uniforms.sourceClamp   = glGetUniformLocation(program, "sourceClamp");
+    uniforms.sigma         = glGetUniformLocation(program, "sigma");
+    uniforms.frame         = glGetUniformLocation(program, "frame");
+    uniforms.historyOffset = glGetUniformLocation(program, "historyOffset");
+    uniforms.historyWeight = glGetUniformLocation(program, "historyWeight");
+}
+
+// The interior shader has no edge-only uniforms: they resolve to -1
+inline void queryUniforms(GLuint program, SGlassUniforms& uniforms) {
+    uniforms.fullSize            = glGetUniformLocation(program, "fullSize");
+    uniforms.refractionStrength  = glGetUniformLocation(program, "refractionStrength");
+    uniforms.chromaticAberration = glGetUniformLocation(program, "chromaticAberration");
+    uniforms.fresnelStrength     = glGetUniformLocation(program, "fresnelStrength");
+    uniforms.specularStrength    = glGetUniformLocation(program, "specularStrength");
+    uniforms.glassOpacity        = glGetUniformLocation(program, "glassOpacity");
+    uniforms.edgeField           = glGetUniformLocation(program, "edgeField");
+    uniforms.edgeFieldSize       = glGetUniformLocation(program, "edgeFieldSize");
+    uniforms.uvPadding           = glGetUniformLocation(program, "uvPadding");
+    uniforms.lensDistortion      = glGetUniformLocation(program, "lensDistortion");
+    uniforms.toneLut             = glGetUniformLocation(program, "toneLut");
+    uniforms.blurRadius          = glGetUniformLocation(program, "blurRadius");
+    uniforms.blurDirection       = glGetUniformLocation(program, "blurDirection");
+}
+
+inline void queryUniforms(GLuint program, SBackdropStatsUniforms& uniforms) {
+    uniforms.sourceOffset = glGetUniformLocation(program, "sourceOffset");
+    uniforms.sourceScale  = glGetUniformLocation(program, "sourceScale");
+    uniforms.sourceClamp  = glGetUniformLocation(program, "sourceClamp");
+    uniforms.footprint    = glGetUniformLocation(program, "footprint");
+}
+#endif
+
+// ── Copies ───────────────────────────────────────────────────────────────────
+
+// The source rect (origin, extent; in source pixels) scaled onto the whole
+// target, where damage (target pixels) covers it. The part of the rect past
+// the source's edges is left out rather than read as undefined pixels.
+//
+// Leaves the read and draw framebuffer bindings changed.
+// Returns the number of pixels copied.
+template <typename Gl, typename Region>
+uint64_t sampleCopy(Gl& gl, const SBuffer& source, const std::array<double, 2>& origin, const std::array<double, 2>& extent, const SBuffer& target,
+                    const Region& damage) {
+    std::array<int, 4> from = {static_cast<int>(origin[0]), static_cast<int>(origin[1]), 0, 0};
+    from[2]                 = from[0] + static_cast<int>(extent[0]);
+    from[3]                 = from[1] + static_cast<int>(extent[1]);
+    std::array<int, 4> to   = {0, 0, target.width, target.height};
+
+    // Target pixels per source pixel: 1, or less at a reduced level of detail
+    const double scaleX = target.width / extent[0];
+    const double scaleY = target.height / extent[1];
+
+    if (from[0] < 0) { to[0] += std::lround(-from[0] * scaleX); from[0] = 0; }
+    if (from[1] < 0) { to[1] += std::lround(-from[1] * scaleY); from[1] = 0; }
+    if (from[2] > source.width)  { to[2] -= std::lround((from[2] - source.width) * scaleX);  from[2] = source.width; }
+    if (from[3] > source.height) { to[3] -= std::lround((from[3] - source.height) * scaleY); from[3] = source.height; }
+
+    gl.bindFramebuffer(GL_READ_FRAMEBUFFER, source.framebuffer);
+    gl.bindFramebuffer(GL_DRAW_FRAMEBUFFER, target.framebuffer);
+    return gl.blit(damage, from, to, GL_LINEAR);
+}
+
+// The source shifted by offset (source pixels) onto the target, pixel for
+// pixel, where damage (target pixels) covers it.
+//
+// Leaves the read and draw framebuffer bindings changed.
+// Returns the number of pixels copied.
+template <typename Gl, typename Region>
+uint64_t copyShifted(Gl& gl, const SBuffer& source, const std::array<int, 2>& offset, const SBuffer& target, const Region& damage) {
+    gl.bindFramebuffer(GL_READ_FRAMEBUFFER, source.framebuffer);
+    gl.bindFramebuffer(GL_DRAW_FRAMEBUFFER, target.framebuffer);
+    return gl.blit(damage, {offset[0], offset[1], offset[0] + target.width, offset[1] + target.height}, {0, 0, target.width, target.height},
+                   GL_NEAREST);
+}
+
+// ── Separable blur ───────────────────────────────────────────────────────────
+
+// Target pixels one pass reads around the pixel it writes: taps + the bilinear texel
+[[nodiscard]] inline double footprintPx(float radius) {
+    return std::min(std::ceil(radius), 8.0f) + 1.0;
+}
+
+// Target pixels around a source rect that its content reaches through render()
+[[nodiscard]] inline double reachPx(float radius, int iterations) {
+    return footprintPx(radius) * (2 * iterations - 1);
+}
+
+// Source pixels around the damage that render() and the fused pass read
+[[nodiscard]] inline double sourceReachPx(float radius, float sampleScale, int iterations) {
+    // The first pass covers the damage grown by reachPx() target pixels and
+    // reads one more footprint of source pixels around it
+    return reachPx(radius, iterations) / sampleScale + footprintPx(radius);
+}
+
+// Variance of one pass's kernel in its own pixels: the discrete Gaussian the
+// taps of gaussianblur.frag approximate, truncated where the shader stops
+[[nodiscard]] inline double passVariance(float radius) {
+    const double sigma     = std::max(radius / 3.0, 0.001);
+    const int    samples   = static_cast<int>(std::min(std::ceil(radius), 8.0f));
+    double       weightSum = 1.0;
+    double       moment    = 0.0;
+    for (int i = 1; i <= samples; i++) {
+        const double weight = std::exp(-0.5 * i * i / (sigma * sigma));
+        weightSum += 2.0 * weight;
+        moment    += 2.0 * weight * i * i;
+    }
+    return moment / weightSum;
+}
+
+// Standard deviation (x, y), in source pixels, of the Gaussian that render()
+// followed by the fused vertical pass amounts to
+[[nodiscard]] inline std::array<double, 2> chainSigmaPx(float radius, float sampleScale, int iterations) {
+    // The first horizontal pass steps in source pixels, every other pass in
+    // sample pixels, 1 / sampleScale source pixels wide
+    const double samplePass = passVariance(radius * sampleScale) / (sampleScale * sampleScale);
+    return {std::sqrt(passVariance(radius) + (iterations - 1) * samplePass), std::sqrt(iterations * samplePass)};
+}
+
+// Every pass but the last vertical one, leaving the result in target.
+//
+// The source rect (origin, extent; in source pixels) maps onto the whole
+// target. The first horizontal pass reads the source directly, clamped to its
+// edge texels; radius is in source pixels and shrinks by sampleScale for the
+// passes at target resolution. Each pass only covers where a later pass reads,
+// starting from damage (target pixels). temp must have the target's size when
+// iterations > 1.
+//
+// Leaves the framebuffer, VAO, texture and viewport bindings changed.
+// Returns the number of pixels blurred.
+template <typename Gl, typename Program, typename Region>
+uint64_t render(Gl& gl, const Program& program, const SBlurUniforms& uniforms, const SBuffer& source, const std::array<double, 2>& origin,
+                const std::array<double, 2>& extent, const SBuffer& target, const SBuffer& temp, const Region& damage, float radius, float sampleScale,
+                int iterations) {
+    const int width  = target.width;
+    const int height = target.height;
+
+    // Each pass only has to be right where a later pass reads it: the last
+    // horizontal pass over the damage grown by the fused vertical kernel, every
+    // earlier pass over one more kernel footprint.
+    const int    passes    = 2 * iterations - 1;
+    const double footprint = footprintPx(radius);
+    auto         drawPass  = [&](int pass) { return gl.drawGrown(damage, footprint * (passes - pass), width, height); };
+
+    gl.useProgram(program, FULLSCREEN_PROJECTION);
+    gl.uniform1f(uniforms.radius, radius);
+    gl.setViewport(0, 0, width, height);
+
+    // First horizontal pass reads the source directly: the rect maps to a
+    // sub-rect of the source texture, clamped to its edge texels, so no copy
+    // into target is needed.
+    const float sourceWidth  = static_cast<float>(source.width);
+    const float sourceHeight = static_cast<float>(source.height);
+
+    gl.bindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    gl.bindTexture(0, source.texture, GL_TEXTURE_2D);
+    gl.uniform2f(uniforms.sourceOffset, static_cast<float>(origin[0]) / sourceWidth, static_cast<float>(origin[1]) / sourceHeight);
+    gl.uniform2f(uniforms.sourceScale, static_cast<float>(extent[0]) / sourceWidth, static_cast<float>(extent[1]) / sourceHeight);
+    gl.uniform4f(uniforms.sourceClamp, 0.5f / sourceWidth, 0.5f / sourceHeight, 1.0f - 0.5f / sourceWidth, 1.0f - 0.5f / sourceHeight);
+    gl.uniform2f(uniforms.direction, 1.0f / sourceWidth, 0.0f);
+    uint64_t pixelsBlurred = drawPass(0);
+
+    // The first pass steps in source pixels, the others in target pixels:
+    // the kernel shrinks with the sample resolution
+    if (iterations > 1) {
+        gl.uniform1f(uniforms.radius, radius * sampleScale);
+        gl.uniform2f(uniforms.sourceOffset, 0.0f, 0.0f);
+        gl.uniform2f(uniforms.sourceScale, 1.0f, 1.0f);
+        gl.uniform4f(uniforms.sourceClamp, 0.0f, 0.0f, 1.0f, 1.0f);
+    }
+
+    // Ping-pong at full resolution: target ↔ temp. Horizontal passes land in
+    // target, so the last one leaves its result there for the fused vertical
+    // pass of the glass shader.
+    for (int iteration = 1; iteration < iterations; iteration++) {
+        // Vertical pass: target → temp
+        gl.bindFramebuffer(GL_FRAMEBUFFER, temp.framebuffer);
+        gl.bindTexture(0, target.texture, GL_TEXTURE_2D);
+        gl.uniform2f(uniforms.direction, 0.0f, 1.0f / height);
+        pixelsBlurred += drawPass(2 * iteration - 1);
+
+        // Horizontal pass: temp → target
+        gl.bindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+        gl.bindTexture(0, temp.texture, GL_TEXTURE_2D);
+        gl.uniform2f(uniforms.direction, 1.0f / width, 0.0f);
+        pixelsBlurred += drawPass(2 * iteration);
+    }
+
+    return pixelsBlurred;
+}
+
+// One-pass Monte Carlo estimate of the whole chain, fused pass included, over
+// the source rect (origin, extent) onto the whole target. Mixed with history
+// (the target's size, shifted by historyOffset target pixels) at historyWeight
+// where the shifted history covers the pixel; frame varies the tap pattern.
+// whole: the target's full rect, as a region.
+//
+// Leaves the framebuffer, VAO, texture and viewport bindings changed.
+// Returns the number of pixels blurred.
+template <typename Gl, typename Program, typename Region>
+uint64_t stochastic(Gl& gl, const Program& program, const SStochasticBlurUniforms& uniforms, const SBuffer& source, const std::array<double, 2>& origin,
+                    const std::array<double, 2>& extent, const SBuffer& target, const SBuffer& history, const Region& whole,
+                    const std::array<double, 2>& historyOffset, float historyWeight, const std::array<double, 2>& sigma, uint32_t frame) {
+    const int   width        = target.width;
+    const int   height       = target.height;
+    const float sourceWidth  = static_cast<float>(source.width);
+    const float sourceHeight = static_cast<float>(source.height);
+
+    gl.useProgram(program, FULLSCREEN_PROJECTION);
+    gl.uniform1i(uniforms.history, 1);
+    gl.uniform2f(uniforms.sourceOffset, static_cast<float>(origin[0]) / sourceWidth, static_cast<float>(origin[1]) / sourceHeight);
+    gl.uniform2f(uniforms.sourceScale, static_cast<float>(extent[0]) / sourceWidth, static_cast<float>(extent[1]) / sourceHeight);
+    gl.uniform4f(uniforms.sourceClamp, 0.5f / sourceWidth, 0.5f / sourceHeight, 1.0f - 0.5f / sourceWidth, 1.0f - 0.5f / sourceHeight);
+    gl.uniform2f(uniforms.sigma, static_cast<float>(sigma[0]) / sourceWidth, static_cast<float>(sigma[1]) / sourceHeight);
+    gl.uniform1f(uniforms.frame, static_cast<float>(frame % 1024));
+    gl.uniform2f(uniforms.historyOffset, static_cast<float>(historyOffset[0]) / width, static_cast<float>(historyOffset[1]) / height);
+    gl.uniform1f(uniforms.historyWeight, historyWeight);
+    gl.setViewport(0, 0, width, height);
+
+    // Unit 0 last, so it is the active unit Hyprland finds after us
+    gl.bindFramebuffer(GL_FRAMEBUFFER, target.framebuffer);
+    gl.bindTexture(1, history.texture, GL_TEXTURE_2D);
+    gl.bindTexture(0, source.texture, GL_TEXTURE_2D);
+
+    return gl.drawGrown(whole, 0.0, width, height);
+}
+
+// ── Glass composite ──────────────────────────────────────────────────────────
+
+// What the composite of one window draws with, resolved
+struct SComposite {
+    GLuint framebuffer    = 0; // drawn into
+    int    viewportWidth  = 0;
+    int    viewportHeight = 0;
+
+    // The window quad: projection as uploaded, box in drawClipped()
+    // coordinates (x, y, w, h), size in framebuffer pixels
+    std::array<float, 9>  projection = {};
+    std::array<double, 4> box        = {};
+    std::array<float, 2>  fullSize   = {};
+    double                interiorInset = 0.0; // 0: the bezel shader covers the whole box
+
+    GLuint sample        = 0;
+    GLuint edgeField     = 0;
+    int    edgeFieldSize = 1;
+    GLuint toneLut       = 0; // 3D
+
+    std::array<float, 2> uvPadding          = {};
+    float                fusedBlurRadius    = 0.0f;
+    std::array<float, 2> fusedBlurDirection = {};
+    float                refractionStrength  = 0.0f;
+    float                chromaticAberration = 0.0f;
+    float                fresnelStrength     = 0.0f;
+    float                specularStrength    = 0.0f;
+    float                glassOpacity        = 0.0f; // window alpha applied
+    float                lensDistortion      = 0.0f;
+};
+
+template <typename Gl, typename Program>
+void uploadGlassUniforms(Gl& gl, const Program& program, const SGlassUniforms& uniforms, const SComposite& composite) {
+    gl.useProgram(program, composite.projection);
+    gl.uniform2f(uniforms.fullSize, composite.fullSize[0], composite.fullSize[1]);
+
+    // Edge-only uniforms resolve to -1 in the interior shader (no-op upload)
+    gl.uniform1f(uniforms.refractionStrength,  composite.refractionStrength);
+    gl.uniform1f(uniforms.chromaticAberration, composite.chromaticAberration);
+    gl.uniform1f(uniforms.fresnelStrength,     composite.fresnelStrength);
+    gl.uniform1f(uniforms.specularStrength,    composite.specularStrength);
+    gl.uniform1f(uniforms.glassOpacity,        composite.glassOpacity);
+    gl.uniform1f(uniforms.lensDistortion,      composite.lensDistortion);
+
+    // Frosted tint and tint overlay: baked per preset and theme, bound to unit 2
+    gl.uniform1i(uniforms.toneLut, 2);
+
+    gl.uniform2f(uniforms.uvPadding, composite.uvPadding[0], composite.uvPadding[1]);
+    gl.uniform1f(uniforms.blurRadius, composite.fusedBlurRadius);
+    gl.uniform2f(uniforms.blurDirection, composite.fusedBlurDirection[0], composite.fusedBlurDirection[1]);
+}
+
+// Both shaders draw the same window quad; scissoring splits it into the
+// bezel ring (full refraction shader) and the inset interior (tone-map only).
+// Every piece is drawn only where it overlaps damage.
+//
+// Leaves the framebuffer, VAO, texture and viewport bindings changed.
+// Returns the number of pixels drawn.
+template <typename Gl, typename Program, typename Region>
+uint64_t composite(Gl& gl, const Program& glass, const SGlassUniforms& glassUniforms, const Program& interior, const SGlassUniforms& interiorUniforms,
+                   const SComposite& composite, const Region& damage) {
+    // Unit 0 last, so it is the active unit Hyprland finds after us
+    gl.bindFramebuffer(GL_FRAMEBUFFER, composite.framebuffer);
+    gl.setViewport(0, 0, composite.viewportWidth, composite.viewportHeight);
+    gl.bindTexture(2, composite.toneLut, GL_TEXTURE_3D);
+    gl.bindTexture(1, composite.edgeField, GL_TEXTURE_2D);
+    gl.bindTexture(0, composite.sample, GL_TEXTURE_2D);
+
+    uploadGlassUniforms(gl, glass, glassUniforms, composite);
+    gl.uniform1i(glassUniforms.edgeField, 1);
+    gl.uniform1i(glassUniforms.edgeFieldSize, composite.edgeFieldSize);
+
+    const auto [x, y, w, h] = composite.box;
+    const double inset      = composite.interiorInset;
+    if (inset <= 0.0 || w <= 2.0 * inset || h <= 2.0 * inset)
+        return gl.drawClipped(damage, x, y, w, h);
+
+    uint64_t pixels = gl.drawClipped(damage, x, y, w, inset);
+    pixels += gl.drawClipped(damage, x, y + h - inset, w, inset);
+    pixels += gl.drawClipped(damage, x, y + inset, inset, h - 2.0 * inset);
+    pixels += gl.drawClipped(damage, x + w - inset, y + inset, inset, h - 2.0 * inset);
+
+    uploadGlassUniforms(gl, interior, interiorUniforms, composite);
+    pixels += gl.drawClipped(damage, x + inset, y + inset, w - 2.0 * inset, h - 2.0 * inset);
+    return pixels;
+}
+
+// ── Backdrop statistics ──────────────────────────────────────────────────────
+
+// Where measure() reduces the statistics and queues their readback
+struct SProbeTarget {
+    GLuint drawFramebuffer = 0; // level 0 of texture
+    GLuint readFramebuffer = 0; // the readback level of texture
+    GLuint texture         = 0;
+    int    size            = 0; // of level 0
+    int    readbackSize    = 0;
+    GLuint buffer          = 0; // pixel pack buffer
+};
+
+// Luminance statistics of the source box (x, y, w, h; source pixels) drawn
+// into the probe's level 0, reduced down its mipmaps, and the readback level
+// queued into the probe's pixel pack buffer. whole: level 0's full rect, as a
+// region.
+//
+// Leaves the framebuffer, VAO, texture and viewport bindings changed.
+// Returns the fence that signals once the readback has landed.
+template <typename Gl, typename Program, typename Region>
+GLsync measure(Gl& gl, const Program& program, const SBackdropStatsUniforms& uniforms, const SBuffer& source, const std::array<double, 4>& box,
+               const SProbeTarget& probe, const Region& whole) {
+    const float sourceWidth  = static_cast<float>(source.width);
+    const float sourceHeight = static_cast<float>(source.height);
+    const float size         = static_cast<float>(probe.size);
+    const float boxWidth     = static_cast<float>(box[2]) / sourceWidth;
+    const float boxHeight    = static_cast<float>(box[3]) / sourceHeight;
+
+    gl.useProgram(program, FULLSCREEN_PROJECTION);
+    gl.uniform2f(uniforms.sourceOffset, static_cast<float>(box[0]) / sourceWidth, static_cast<float>(box[1]) / sourceHeight);
+    gl.uniform2f(uniforms.sourceScale, boxWidth, boxHeight);
+    gl.uniform4f(uniforms.sourceClamp, 0.5f / sourceWidth, 0.5f / sourceHeight, 1.0f - 0.5f / sourceWidth, 1.0f - 0.5f / sourceHeight);
+    gl.uniform2f(uniforms.footprint, boxWidth / size, boxHeight / size);
+    gl.bindFramebuffer(GL_FRAMEBUFFER, probe.drawFramebuffer);
+    gl.bindTexture(0, source.texture, GL_TEXTURE_2D);
+    gl.setViewport(0, 0, probe.size, probe.size);
+    gl.drawGrown(whole, 0.0, probe.size, probe.size);
+
+    gl.bindTexture(0, probe.texture, GL_TEXTURE_2D);
+    gl.generateMipmap(GL_TEXTURE_2D);
+
+    gl.bindFramebuffer(GL_READ_FRAMEBUFFER, probe.readFramebuffer);
+    gl.readPixels(probe.buffer, 0, 0, probe.readbackSize, probe.readbackSize);
+    return gl.fenceSync();
+}
+
+// Hands the texels of a readback to onTexels once its fence has signaled, and
+// deletes the fence. False while the readback is in flight: the GPU is never
+// waited on.
+template <typename Gl, typename FTexels>
+bool collectReadback(Gl& gl, GLsync& fence, GLuint buffer, size_t bytes, const FTexels& onTexels) {
+    if (!gl.fenceSignaled(fence))
+        return false;
+
+    gl.deleteSync(fence);
+    fence = nullptr;
+
+    if (const auto* texels = static_cast<const float*>(gl.mapBuffer(buffer, bytes))) {
+        onTexels(texels);
+        gl.unmapBuffer();
+    }
+    return true;
+}
+
+} // namespace GlassPasses
@@ -1,7 +1,16 @@
 #pragma once
 
+#include "BackdropCache.hpp"
+#include "BlurPasses.hpp"
+#include "Capture.hpp"
+#include "DecorationRegistry.hpp"
+#include "GLState.hpp"
 #include "PluginConfig.hpp"
+#include "RefreshScheduler.hpp"
 #include "ShaderManager.hpp"
+#include "Telemetry.hpp"
+#include "ToneLut.hpp"
+#include "VramTracker.hpp"
 
 #include <hyprland/src/plugins/PluginAPI.hpp>
 #include <hyprland/src/render/Framebuffer.hpp>
@@ -9,18 +18,45 @@
 #include <string_view>
 #include <vector>
 
-class CGlassDecoration;
-
 struct SGlobalState {
-    std::vector<WP<CGlassDecoration>> decorations;
-    CShaderManager                    shaderManager;
-    SPluginConfig                     config;
+    CDecorationRegistry decorations;
+    CShaderManager      shaderManager;
+    SPluginConfig       config;
 
     // User-defined presets (populated from config keyword, swapped in on configReloaded)
     std::unordered_map<std::string, SCustomPreset> customPresets;
 
+    // customPresets flattened with the config layers, indexed by PresetId
+    SPresetTable presetTable;
+
     // Shared blur temp framebuffer (reused across all decorations since they render sequentially)
-    CFramebuffer blurTempFramebuffer;
+    CFramebuffer    blurTempFramebuffer;
+    CVramAllocation blurTempVram{VRAM_BLUR_TEMP};
+
+    // Byte totals of the plugin's GPU resources and the VRAM budget
+    CVramTracker vram;
+
+    // Blurred wallpaper and bottom layers per monitor (plugin:hyprglass:backdrop_cache)
+    CBackdropCache backdropCache;
+
+    // Frosted tint baked per preset and theme
+    CToneLuts toneLuts;
+
+    // Wake-ups for backdrop refreshes put off by backdrop_fps
+    CRefreshScheduler refreshScheduler;
+
+    // Shadow of the GL binds and uniforms issued by the plugin
+    CGLStateCache glState;
+    // GlassPasses draws through it
+    BlurPasses::CPassContext passContext;
+
+    // Per-frame metrics for external monitoring (plugin:hyprglass:telemetry)
+    CTelemetryPublisher telemetry;
+
+    // Frame inputs for tools/hyprglass-replay (hyprctl hyprglass capture)
+    CCaptureRecorder capture;
+
+    SP<SHyprCtlCommand> hyprCtlCommand;
 };
 
 inline HANDLE                        PHANDLE = nullptr;
@@ -0,0 +1,128 @@
+#include "GpuTimer.hpp"
+#include "Globals.hpp"
+
+#include <EGL/egl.h>
+#include <GLES2/gl2ext.h>
+#include <chrono>
+#include <cstring>
+
+static PFNGLQUERYCOUNTEREXTPROC        s_queryCounter       = nullptr;
+static PFNGLGETQUERYOBJECTUI64VEXTPROC s_getQueryObjectUi64 = nullptr;
+
+// glGet* can stall the pipeline: counted against the GL budget
+static void countStallProneCall() {
+    if (g_pGlobalState)
+        g_pGlobalState->glState.countStallProneCall();
+}
+
+static int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void CGpuTimer::probe() {
+    m_probed = true;
+
+    countStallProneCall();
+    const auto* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+    if (!extensions || !std::strstr(extensions, "GL_EXT_disjoint_timer_query"))
+        return;
+
+    if (!s_queryCounter)
+        s_queryCounter = reinterpret_cast<PFNGLQUERYCOUNTEREXTPROC>(eglGetProcAddress("glQueryCounterEXT"));
+    if (!s_getQueryObjectUi64)
+        s_getQueryObjectUi64 = reinterpret_cast<PFNGLGETQUERYOBJECTUI64VEXTPROC>(eglGetProcAddress("glGetQueryObjectui64vEXT"));
+
+    m_supported = s_queryCounter && s_getQueryObjectUi64;
+    if (m_supported)
+        calibrate();
+}
+
+void CGpuTimer::calibrate() {
+    GLint64 gpuNow = 0;
+    countStallProneCall();
+    glGetInteger64v(GL_TIMESTAMP_EXT, &gpuNow);
+    m_gpuToCpuNs = steadyNowNs() - gpuNow;
+}
+
+bool CGpuTimer::supported() {
+    if (!m_probed)
+        probe();
+
+    return m_supported;
+}
+
+GLuint CGpuTimer::acquireQuery() {
+    if (!m_freeQueries.empty()) {
+        const GLuint query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+        return query;
+    }
+
+    GLuint query = 0;
+    glGenQueries(1, &query);
+    return query;
+}
+
+GLuint CGpuTimer::begin() {
+    if (!supported())
+        return 0;
+
+    const GLuint query = acquireQuery();
+    s_queryCounter(query, GL_TIMESTAMP_EXT);
+    return query;
+}
+
+void CGpuTimer::end(GLuint beginQuery, uint64_t tag) {
+    if (!beginQuery)
+        return;
+
+    const GLuint endQuery = acquireQuery();
+    s_queryCounter(endQuery, GL_TIMESTAMP_EXT);
+    m_pending.push_back({tag, beginQuery, endQuery});
+}
+
+void CGpuTimer::collect(const FRangeCallback& onRange) {
+    if (!m_supported || m_pending.empty())
+        return;
+
+    GLint disjoint = 0;
+    countStallProneCall();
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+
+    while (!m_pending.empty()) {
+        const auto range = m_pending.front();
+
+        if (!disjoint) {
+            GLuint available = 0;
+            glGetQueryObjectuiv(range.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+
+            GLuint64 begin = 0, end = 0;
+            s_getQueryObjectUi64(range.beginQuery, GL_QUERY_RESULT, &begin);
+            s_getQueryObjectUi64(range.endQuery, GL_QUERY_RESULT, &end);
+            if (end >= begin)
+                onRange(range.tag, static_cast<uint64_t>(static_cast<int64_t>(begin) + m_gpuToCpuNs), end - begin);
+        }
+
+        m_freeQueries.push_back(range.beginQuery);
+        m_freeQueries.push_back(range.endQuery);
+        m_pending.pop_front();
+    }
+
+    // Timestamps across a disjoint event are meaningless: drop them and re-sync the clocks
+    if (disjoint)
+        calibrate();
+}
+
+void CGpuTimer::release() noexcept {
+    for (const auto& range : m_pending) {
+        m_freeQueries.push_back(range.beginQuery);
+        m_freeQueries.push_back(range.endQuery);
+    }
+    m_pending.clear();
+
+    if (!m_freeQueries.empty())
+        glDeleteQueries(static_cast<GLsizei>(m_freeQueries.size()), m_freeQueries.data());
+    m_freeQueries.clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <GLES3/gl32.h>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// GPU time of command ranges, from EXT_disjoint_timer_query timestamps.
+//
+// A range is bracketed by two timestamp queries. collect() hands back the
+// finished ranges in submission order once their results are available, a
+// few frames later, so nothing ever waits on the GPU. It does query the
+// disjoint flag, so call it once per frame or less. Ranges spanning a
+// disjoint event (GPU reset, clock change) are dropped. The extension is
+// probed on first use, and release() deletes the queries: both need the
+// compositor's context to be current.
+class CGpuTimer {
+  public:
+    CGpuTimer() = default;
+
+    CGpuTimer(const CGpuTimer&)            = delete;
+    CGpuTimer& operator=(const CGpuTimer&) = delete;
+
+    [[nodiscard]] bool supported();
+
+    // Returns the begin query to hand to end(), 0 if timestamps are unsupported
+    [[nodiscard]] GLuint begin();
+    void                 end(GLuint beginQuery, uint64_t tag);
+
+    // Start on the steady_clock, duration in nanoseconds
+    using FRangeCallback = std::function<void(uint64_t tag, uint64_t startNs, uint64_t durationNs)>;
+    void collect(const FRangeCallback& onRange);
+
+    [[nodiscard]] size_t pendingRanges() const noexcept { return m_pending.size(); }
+
+    void release() noexcept;
+
+  private:
+    struct SRange {
+        uint64_t tag;
+        GLuint   beginQuery;
+        GLuint   endQuery;
+    };
+
+    bool                m_probed       = false;
+    bool                m_supported    = false;
+    int64_t             m_gpuToCpuNs   = 0;
+    std::deque<SRange>  m_pending;
+    std::vector<GLuint> m_freeQueries;
+
+    void   probe();
+    void   calibrate();
+    GLuint acquireQuery();
+};
@@ -0,0 +1,232 @@
+#include "HyprCtl.hpp"
+#include "Globals.hpp"
+#include "Trace.hpp"
+
+#include <array>
+#include <format>
+#include <string_view>
+
+// ── Subcommands ──────────────────────────────────────────────────────────────
+
+static constexpr std::array<std::string_view, CGLStateCache::COUNTER_LAST> COUNTER_NAMES = {
+    "framebuffer", "vertex_array", "texture", "viewport", "uniform",
+};
+
+static constexpr std::array<std::string_view, CGLStateCache::WORK_LAST> WORK_NAMES = {
+    "draws", "pixels", "allocations", "stall_prone_calls",
+};
+
+static std::string statsCommand(eHyprCtlOutputFormat format, std::string_view args) {
+    auto& glState = g_pGlobalState->glState;
+
+    if (args == "reset") {
+        glState.resetCounters();
+        return format == FORMAT_JSON ? "{\"ok\": true}" : "ok\n";
+    }
+
+    const double passes = static_cast<double>(std::max<uint64_t>(glState.renderPasses(), 1));
+    uint64_t     totalIssued = 0, totalSkipped = 0;
+
+    std::string result;
+    if (format == FORMAT_JSON)
+        result = std::format("{{\"renderPasses\": {}, \"counters\": {{", glState.renderPasses());
+    else
+        result = std::format("GL state cache over {} window render passes\n", glState.renderPasses());
+
+    for (size_t i = 0; i < COUNTER_NAMES.size(); i++) {
+        const auto& counter = glState.counter(static_cast<CGLStateCache::eCounter>(i));
+        totalIssued += counter.issued;
+        totalSkipped += counter.skipped;
+
+        if (format == FORMAT_JSON)
+            result += std::format("{}\"{}\": {{\"issued\": {}, \"skipped\": {}}}", i ? ", " : "", COUNTER_NAMES[i], counter.issued, counter.skipped);
+        else
+            result += std::format("  {:<14} issued {:>10}  skipped {:>10}\n", COUNTER_NAMES[i], counter.issued, counter.skipped);
+    }
+
+    if (format == FORMAT_JSON)
+        result += std::format("}}, \"issuedPerPass\": {:.2f}, \"skippedPerPass\": {:.2f}, \"work\": {{", totalIssued / passes, totalSkipped / passes);
+    else
+        result += std::format("  per window pass: {:.2f} calls issued, {:.2f} skipped\nGL work\n", totalIssued / passes, totalSkipped / passes);
+
+    for (size_t i = 0; i < WORK_NAMES.size(); i++) {
+        const auto& work = glState.work(static_cast<CGLStateCache::eWork>(i));
+
+        if (format == FORMAT_JSON)
+            result += std::format("{}\"{}\": {{\"total\": {}, \"perPass\": {:.2f}, \"maxPass\": {}}}", i ? ", " : "", WORK_NAMES[i], work.total,
+                                  work.total / passes, work.maxPass);
+        else
+            result += std::format("  {:<18} total {:>12}  per pass {:>12.2f}  max {:>10}\n", WORK_NAMES[i], work.total, work.total / passes, work.maxPass);
+    }
+
+    // Steady state: passes that reused their sample must not allocate or stall
+    if (format == FORMAT_JSON)
+        result += std::format("}}, \"steadyStatePasses\": {}, \"budgetViolations\": {}, \"lastBudgetViolation\": \"{}\"}}", glState.steadyStatePasses(),
+                              glState.budgetViolations(), glState.lastBudgetViolation());
+    else {
+        result += std::format("steady-state passes: {}, budget violations: {}\n", glState.steadyStatePasses(), glState.budgetViolations());
+        if (glState.budgetViolations())
+            result += std::format("  last: {}\n", glState.lastBudgetViolation());
+    }
+
+    return result;
+}
+
+static constexpr std::array<std::string_view, VRAM_LAST> VRAM_CATEGORY_NAMES = {
+    "sample", "blur_temp", "edge_field", "backdrop_probe", "backdrop_cache", "tone_lut",
+};
+
+static double toMiB(size_t bytes) {
+    return static_cast<double>(bytes) / (1024.0 * 1024.0);
+}
+
+static std::string vramCommand(eHyprCtlOutputFormat format, std::string_view args) {
+    const auto&  vram   = g_pGlobalState->vram;
+    const size_t total  = vram.totalBytes();
+    const size_t budget = vram.budgetBytes();
+
+    std::string result;
+    if (format == FORMAT_JSON)
+        result = std::format("{{\"totalBytes\": {}, \"budgetBytes\": {}, \"evictions\": {}, \"idleReleases\": {}, \"categories\": {{", total, budget,
+                             vram.evictions(), vram.idleReleases());
+    else if (budget)
+        result = std::format("VRAM held: {:.1f} MiB of a {:.0f} MiB budget{}\n", toMiB(total), toMiB(budget), total > budget ? " (over budget)" : "");
+    else
+        result = std::format("VRAM held: {:.1f} MiB (no budget)\n", toMiB(total));
+
+    for (size_t i = 0; i < VRAM_CATEGORY_NAMES.size(); i++) {
+        const auto& category = vram.category(static_cast<eVramCategory>(i));
+
+        if (format == FORMAT_JSON)
+            result += std::format("{}\"{}\": {{\"bytes\": {}, \"allocations\": {}}}", i ? ", " : "", VRAM_CATEGORY_NAMES[i], category.bytes,
+                                  category.allocations);
+        else
+            result += std::format("  {:<14} {:>4} allocations  {:>9.2f} MiB\n", VRAM_CATEGORY_NAMES[i], category.allocations, toMiB(category.bytes));
+    }
+
+    if (format == FORMAT_JSON)
+        result += "}}";
+    else
+        result += std::format("  evictions: {} over budget, {} idle\n", vram.evictions(), vram.idleReleases());
+
+    return result;
+}
+
+static std::string jsonEscape(std::string_view text) {
+    std::string escaped;
+    for (const char c : text) {
+        if (c == '"' || c == '\\')
+            escaped += '\\';
+        if (static_cast<unsigned char>(c) < 0x20)
+            escaped += std::format("\\u{:04x}", static_cast<unsigned char>(c));
+        else
+            escaped += c;
+    }
+    return escaped;
+}
+
+// "trace start [path]" / "trace stop"
+static std::string traceCommand(eHyprCtlOutputFormat format, std::string_view args) {
+    Trace::SStatus status;
+
+    if (args == "stop")
+        status = Trace::stop();
+    else if (args == "start" || args.starts_with("start ")) {
+        auto path = args.substr(std::min(args.size(), std::string_view("start").size()));
+        while (!path.empty() && path.front() == ' ')
+            path.remove_prefix(1);
+        status = Trace::start(path);
+    } else
+        status = {false, "usage: trace <start [path]|stop>"};
+
+    if (format == FORMAT_JSON)
+        return std::format("{{\"ok\": {}, \"status\": \"{}\"}}", status.ok, jsonEscape(status.text));
+    return status.text + "\n";
+}
+
+// "capture start [backdrop] [path]" / "capture stop"
+static std::string captureCommand(eHyprCtlOutputFormat format, std::string_view args) {
+    auto&       capture = g_pGlobalState->capture;
+    std::string status;
+    bool        ok = true;
+
+    if (args == "stop")
+        status = capture.stop();
+    else if (args == "start" || args.starts_with("start ")) {
+        auto rest = args.substr(std::min(args.size(), std::string_view("start").size()));
+        while (!rest.empty() && rest.front() == ' ')
+            rest.remove_prefix(1);
+        status = capture.start(rest);
+        ok     = capture.active();
+    } else {
+        status = "usage: capture <start [backdrop] [path]|stop>";
+        ok     = false;
+    }
+
+    if (format == FORMAT_JSON)
+        return std::format("{{\"ok\": {}, \"status\": \"{}\"}}", ok, jsonEscape(status));
+    return status + "\n";
+}
+
+struct SSubcommand {
+    std::string_view name;
+    std::string (*run)(eHyprCtlOutputFormat format, std::string_view args);
+};
+
+static constexpr std::array<SSubcommand, 4> SUBCOMMANDS = {{
+    {"capture", captureCommand},
+    {"stats", statsCommand},
+    {"trace", traceCommand},
+    {"vram", vramCommand},
+}};
+
+// ── Dispatch ─────────────────────────────────────────────────────────────────
+
+static std::string usage(eHyprCtlOutputFormat format) {
+    std::string names;
+    for (const auto& subcommand : SUBCOMMANDS)
+        names += std::format("{}{}", names.empty() ? "" : "|", subcommand.name);
+
+    if (format == FORMAT_JSON)
+        return std::format("{{\"error\": \"usage: hyprctl {} <{}>\"}}", PLUGIN_NAME, names);
+    return std::format("usage: hyprctl {} <{}>\n", PLUGIN_NAME, names);
+}
+
+static std::string dispatch(eHyprCtlOutputFormat format, std::string request) {
+    if (!g_pGlobalState)
+        return "";
+
+    // request is the full command line: "hyprglass <subcommand> [args]"
+    std::string_view rest = request;
+    rest.remove_prefix(std::min(rest.size(), PLUGIN_NAME.size()));
+    while (!rest.empty() && rest.front() == ' ')
+        rest.remove_prefix(1);
+
+    const auto             split = rest.find(' ');
+    const std::string_view name  = rest.substr(0, split);
+    std::string_view       args  = split == std::string_view::npos ? std::string_view{} : rest.substr(split + 1);
+    while (!args.empty() && args.back() == ' ')
+        args.remove_suffix(1);
+
+    for (const auto& subcommand : SUBCOMMANDS) {
+        if (subcommand.name == name)
+            return subcommand.run(format, args);
+    }
+
+    return usage(format);
+}
+
+void registerHyprCtlCommands(HANDLE handle) {
+    g_pGlobalState->hyprCtlCommand = HyprlandAPI::registerHyprCtlCommand(handle, SHyprCtlCommand{
+        .name  = std::string(PLUGIN_NAME),
+        .exact = false,
+        .fn    = dispatch,
+    });
+}
+
+void unregisterHyprCtlCommands(HANDLE handle) {
+    if (g_pGlobalState->hyprCtlCommand)
+        HyprlandAPI::unregisterHyprCtlCommand(handle, g_pGlobalState->hyprCtlCommand);
+
+    g_pGlobalState->hyprCtlCommand.reset();
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include <hyprland/src/plugins/PluginAPI.hpp>
+
+// `hyprctl hyprglass <subcommand>`: runtime introspection of the plugin
+void registerHyprCtlCommands(HANDLE handle);
+void unregisterHyprCtlCommands(HANDLE handle);
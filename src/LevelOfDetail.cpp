@@ -0,0 +1,132 @@
+#include "LevelOfDetail.hpp"
+#include "BlurPasses.hpp"
+#include "Globals.hpp"
+#include "WindowGeometry.hpp"
+
+#include <algorithm>
+#include <hyprland/src/Compositor.hpp>
+#include <hyprland/src/desktop/rule/windowRule/WindowRuleApplicator.hpp>
+#include <hyprutils/math/Region.hpp>
+#include <optional>
+#include <vector>
+
+namespace LevelOfDetail {
+
+static constexpr std::array<std::string_view, TIER_LAST> TIER_NAMES = {"high", "medium", "low"};
+
+static std::optional<eTier> taggedTier(const PHLWINDOW& window) {
+    if (!window->m_ruleApplicator)
+        return std::nullopt;
+
+    for (const auto& tag : window->m_ruleApplicator->m_tagKeeper.getTags()) {
+        if (!tag.starts_with(TAG_LOD_PREFIX))
+            continue;
+
+        const auto name = std::string_view(tag).substr(TAG_LOD_PREFIX.size());
+        for (size_t tier = 0; tier < TIER_NAMES.size(); tier++) {
+            if (TIER_NAMES[tier] == name)
+                return static_cast<eTier>(tier);
+        }
+    }
+
+    return std::nullopt;
+}
+
+void updateVisibility(CDecorationRegistry& registry) {
+    struct SStacked {
+        CWindow* window;
+        int      layer;
+        size_t   order;
+    };
+    // Opaque windows above the ones still to come in the sweep. Pinned ones
+    // cover every workspace, the others only their own.
+    struct SCover {
+        const CWorkspace* workspace = nullptr;
+        CRegion           region;
+    };
+
+    // Kept between frames for their storage
+    static std::vector<SStacked> stack;
+    static std::vector<SCover>   covers;
+    static CRegion               pinnedCover;
+    static CRegion               visible;
+
+    stack.clear();
+    for (size_t i = 0; i < g_pCompositor->m_windows.size(); i++) {
+        const auto& window = g_pCompositor->m_windows[i];
+        stack.push_back({window.get(), WindowGeometry::stackingLayer(window), i});
+    }
+    // Top first: within a floating layer the later one is on top
+    std::ranges::sort(stack, [](const SStacked& a, const SStacked& b) { return a.layer != b.layer ? a.layer > b.layer : a.order > b.order; });
+
+    size_t usedCovers = 0;
+    pinnedCover.clear();
+
+    auto coverOf = [&](const CWorkspace* workspace) -> CRegion& {
+        for (size_t i = 0; i < usedCovers; i++) {
+            if (covers[i].workspace == workspace)
+                return covers[i].region;
+        }
+        if (usedCovers == covers.size())
+            covers.emplace_back();
+        auto& cover     = covers[usedCovers++];
+        cover.workspace = workspace;
+        return cover.region.clear();
+    };
+
+    for (const auto& stacked : stack) {
+        auto*      window = stacked.window;
+        const CBox box    = window->getWindowMainSurfaceBox();
+
+        if (auto* entry = registry.find(window)) {
+            visible.set(CRegion(box)).subtract(pinnedCover).subtract(coverOf(window->m_workspace.get()));
+
+            double visibleArea = 0.0;
+            for (const auto& rect : BlurPasses::rects(visible))
+                visibleArea += static_cast<double>(rect.x2 - rect.x1) * (rect.y2 - rect.y1);
+
+            const double area      = box.width * box.height;
+            entry->visibleFraction = area > 0.0 ? std::clamp(visibleArea / area, 0.0, 1.0) : 0.0;
+        }
+
+        // Tiled windows never overlap each other, and nothing is below them
+        if (stacked.layer == 0 || !window->m_isMapped || window->isHidden() || window->m_fadingOut || !window->opaque())
+            continue;
+
+        (window->m_pinned ? pinnedCover : coverOf(window->m_workspace.get())).add(box);
+    }
+}
+
+eTier selectTier(const PHLWINDOW& window, const PHLMONITOR& monitor, double visibleFraction) {
+    if (const auto tier = taggedTier(window))
+        return *tier;
+
+    const auto& lod = g_pGlobalState->config.lod;
+    if (!lod.enabled || !**lod.enabled || !monitor)
+        return TIER_HIGH;
+
+    const CBox   box         = window->getWindowMainSurfaceBox();
+    const double monitorArea = monitor->m_size.x * monitor->m_size.y;
+    const double areaShare   = monitorArea > 0.0 ? box.width * box.height / monitorArea : 1.0;
+
+    if (areaShare < **lod.lowArea)
+        return TIER_LOW;
+
+    if (visibleFraction < **lod.lowVisible)
+        return TIER_LOW;
+
+    if (areaShare < **lod.mediumArea || visibleFraction < **lod.mediumVisible)
+        return TIER_MEDIUM;
+
+    return TIER_HIGH;
+}
+
+void applyTier(eTier tier, SPresetValues& params) {
+    const auto& settings = TIER_SETTINGS[tier];
+
+    params.blurIterations = std::min(params.blurIterations, settings.maxBlurIterations);
+    if (!settings.chromaticAberration)
+        params.chromaticAberration = 0.0f;
+}
+
+} // namespace LevelOfDetail
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PluginConfig.hpp"
+
+#include <hyprland/src/desktop/view/Window.hpp>
+#include <array>
+#include <cstdint>
+
+class CDecorationRegistry;
+
+// Per-window level of detail: how much of the glass pipeline a window is
+// worth. Chosen from its share of the monitor, the fraction of it not hidden
+// behind opaque windows, or forced with a hyprglass_lod_<high|medium|low> tag.
+namespace LevelOfDetail {
+
+enum eTier : uint8_t {
+    TIER_HIGH = 0,
+    TIER_MEDIUM,
+    TIER_LOW,
+    TIER_LAST,
+};
+
+struct STierSettings {
+    int64_t maxBlurIterations;
+    bool    chromaticAberration; // off: one blurred fetch per pixel instead of three
+    float   sampleScale;         // sample framebuffer resolution relative to the monitor
+};
+
+inline constexpr std::array<STierSettings, TIER_LAST> TIER_SETTINGS = {{
+    {5, true, 1.0f},
+    {2, false, 1.0f},
+    {1, false, 0.5f},
+}};
+
+// visibleFraction: from the window's registry entry
+[[nodiscard]] eTier selectTier(const PHLWINDOW& window, const PHLMONITOR& monitor, double visibleFraction);
+
+// Sets every decorated window's visibleFraction: the share of its main surface
+// not covered by opaque windows above it. One sweep down the stacking order.
+void updateVisibility(CDecorationRegistry& registry);
+
+// Caps the preset's cost to what the tier allows
+void applyTier(eTier tier, SPresetValues& params);
+
+} // namespace LevelOfDetail
@@ -13,6 +13,18 @@ void registerConfig(HANDLE handle) {
     HyprlandAPI::addConfigValue(handle, ConfigKeys::ENABLED, Hyprlang::INT{1});
     HyprlandAPI::addConfigValue(handle, ConfigKeys::DEFAULT_THEME, Hyprlang::STRING{"dark"});
     HyprlandAPI::addConfigValue(handle, ConfigKeys::DEFAULT_PRESET, Hyprlang::STRING{"default"});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::VRAM_BUDGET_MB, Hyprlang::INT{0});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::IDLE_RELEASE_SECONDS, Hyprlang::INT{60});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::BACKDROP_CACHE, Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::TELEMETRY, Hyprlang::INT{0});
+
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::LOD_ENABLED, Hyprlang::INT{1});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::LOD_MEDIUM_AREA, Hyprlang::FLOAT{LodDefaults::MEDIUM_AREA});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::LOD_LOW_AREA, Hyprlang::FLOAT{LodDefaults::LOW_AREA});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::LOD_MEDIUM_VISIBLE, Hyprlang::FLOAT{LodDefaults::MEDIUM_VISIBLE});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::LOD_LOW_VISIBLE, Hyprlang::FLOAT{LodDefaults::LOW_VISIBLE});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::UNIFORM_BACKDROP_THRESHOLD, Hyprlang::FLOAT{LodDefaults::UNIFORM_BACKDROP_THRESHOLD});
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::STOCHASTIC_BLUR, Hyprlang::INT{0});
 
     // Global level — real defaults for effect settings,
     // sentinel for theme-sensitive settings (fallback to hardcoded theme defaults)
@@ -33,6 +45,7 @@ void registerConfig(HANDLE handle) {
     HyprlandAPI::addConfigValue(handle, ConfigKeys::VIBRANCY_DARKNESS, SENTINEL_FLOAT);
     HyprlandAPI::addConfigValue(handle, ConfigKeys::ADAPTIVE_DIM, SENTINEL_FLOAT);
     HyprlandAPI::addConfigValue(handle, ConfigKeys::ADAPTIVE_BOOST, SENTINEL_FLOAT);
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::BACKDROP_FPS, Hyprlang::INT{GlobalDefaults::BACKDROP_FPS});
 
     // Dark theme overrides — all sentinel (inherit from global)
     HyprlandAPI::addConfigValue(handle, ConfigKeys::DARK_BLUR_STRENGTH, SENTINEL_FLOAT);
@@ -52,6 +65,7 @@ void registerConfig(HANDLE handle) {
     HyprlandAPI::addConfigValue(handle, ConfigKeys::DARK_VIBRANCY_DARKNESS, SENTINEL_FLOAT);
     HyprlandAPI::addConfigValue(handle, ConfigKeys::DARK_ADAPTIVE_DIM, SENTINEL_FLOAT);
     HyprlandAPI::addConfigValue(handle, ConfigKeys::DARK_ADAPTIVE_BOOST, SENTINEL_FLOAT);
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::DARK_BACKDROP_FPS, SENTINEL_INT);
 
     // Light theme overrides — all sentinel (inherit from global)
     HyprlandAPI::addConfigValue(handle, ConfigKeys::LIGHT_BLUR_STRENGTH, SENTINEL_FLOAT);
@@ -71,6 +85,7 @@ void registerConfig(HANDLE handle) {
     HyprlandAPI::addConfigValue(handle, ConfigKeys::LIGHT_VIBRANCY_DARKNESS, SENTINEL_FLOAT);
     HyprlandAPI::addConfigValue(handle, ConfigKeys::LIGHT_ADAPTIVE_DIM, SENTINEL_FLOAT);
     HyprlandAPI::addConfigValue(handle, ConfigKeys::LIGHT_ADAPTIVE_BOOST, SENTINEL_FLOAT);
+    HyprlandAPI::addConfigValue(handle, ConfigKeys::LIGHT_BACKDROP_FPS, SENTINEL_INT);
 
     // Registered as unscoped because Hyprlang does not dispatch
     // scoped keyword handlers inside the plugin special category.
@@ -93,7 +108,7 @@ static void initOverridablePointers(HANDLE handle, SOverridableConfig& layer,
                                     const char* brightness, const char* contrast,
                                     const char* saturation, const char* vibrancy,
                                     const char* vibrancyDarkness, const char* adaptiveDim,
-                                    const char* adaptiveBoost) {
+                                    const char* adaptiveBoost, const char* backdropFps) {
     layer.blurStrength        = getStaticPtr<Hyprlang::FLOAT>(handle, blurStrength);
     layer.blurIterations      = getStaticPtr<Hyprlang::INT>(handle, blurIterations);
     layer.refractionStrength  = getStaticPtr<Hyprlang::FLOAT>(handle, refractionStrength);
@@ -111,12 +126,25 @@ static void initOverridablePointers(HANDLE handle, SOverridableConfig& layer,
     layer.vibrancyDarkness    = getStaticPtr<Hyprlang::FLOAT>(handle, vibrancyDarkness);
     layer.adaptiveDim         = getStaticPtr<Hyprlang::FLOAT>(handle, adaptiveDim);
     layer.adaptiveBoost       = getStaticPtr<Hyprlang::FLOAT>(handle, adaptiveBoost);
+    layer.backdropFps         = getStaticPtr<Hyprlang::INT>(handle, backdropFps);
 }
 
 void initConfigPointers(HANDLE handle, SPluginConfig& config) {
     config.enabled       = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::ENABLED);
     config.defaultTheme  = (Hyprlang::STRING const*)HyprlandAPI::getConfigValue(handle, ConfigKeys::DEFAULT_THEME)->getDataStaticPtr();
     config.defaultPreset = (Hyprlang::STRING const*)HyprlandAPI::getConfigValue(handle, ConfigKeys::DEFAULT_PRESET)->getDataStaticPtr();
+    config.vramBudgetMb       = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::VRAM_BUDGET_MB);
+    config.idleReleaseSeconds = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::IDLE_RELEASE_SECONDS);
+    config.backdropCache      = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::BACKDROP_CACHE);
+    config.telemetry          = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::TELEMETRY);
+
+    config.lod.enabled       = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::LOD_ENABLED);
+    config.lod.mediumArea    = getStaticPtr<Hyprlang::FLOAT>(handle, ConfigKeys::LOD_MEDIUM_AREA);
+    config.lod.lowArea       = getStaticPtr<Hyprlang::FLOAT>(handle, ConfigKeys::LOD_LOW_AREA);
+    config.lod.mediumVisible = getStaticPtr<Hyprlang::FLOAT>(handle, ConfigKeys::LOD_MEDIUM_VISIBLE);
+    config.lod.lowVisible    = getStaticPtr<Hyprlang::FLOAT>(handle, ConfigKeys::LOD_LOW_VISIBLE);
+    config.lod.uniformBackdropThreshold = getStaticPtr<Hyprlang::FLOAT>(handle, ConfigKeys::UNIFORM_BACKDROP_THRESHOLD);
+    config.lod.stochasticBlur           = getStaticPtr<Hyprlang::INT>(handle, ConfigKeys::STOCHASTIC_BLUR);
 
     initOverridablePointers(handle, config.global,
         ConfigKeys::BLUR_STRENGTH, ConfigKeys::BLUR_ITERATIONS,
@@ -127,7 +155,7 @@ void initConfigPointers(HANDLE handle, SPluginConfig& config) {
         ConfigKeys::BRIGHTNESS, ConfigKeys::CONTRAST,
         ConfigKeys::SATURATION, ConfigKeys::VIBRANCY,
         ConfigKeys::VIBRANCY_DARKNESS, ConfigKeys::ADAPTIVE_DIM,
-        ConfigKeys::ADAPTIVE_BOOST);
+        ConfigKeys::ADAPTIVE_BOOST, ConfigKeys::BACKDROP_FPS);
 
     initOverridablePointers(handle, config.dark,
         ConfigKeys::DARK_BLUR_STRENGTH, ConfigKeys::DARK_BLUR_ITERATIONS,
@@ -138,7 +166,7 @@ void initConfigPointers(HANDLE handle, SPluginConfig& config) {
         ConfigKeys::DARK_BRIGHTNESS, ConfigKeys::DARK_CONTRAST,
         ConfigKeys::DARK_SATURATION, ConfigKeys::DARK_VIBRANCY,
         ConfigKeys::DARK_VIBRANCY_DARKNESS, ConfigKeys::DARK_ADAPTIVE_DIM,
-        ConfigKeys::DARK_ADAPTIVE_BOOST);
+        ConfigKeys::DARK_ADAPTIVE_BOOST, ConfigKeys::DARK_BACKDROP_FPS);
 
     initOverridablePointers(handle, config.light,
         ConfigKeys::LIGHT_BLUR_STRENGTH, ConfigKeys::LIGHT_BLUR_ITERATIONS,
@@ -149,7 +177,7 @@ void initConfigPointers(HANDLE handle, SPluginConfig& config) {
         ConfigKeys::LIGHT_BRIGHTNESS, ConfigKeys::LIGHT_CONTRAST,
         ConfigKeys::LIGHT_SATURATION, ConfigKeys::LIGHT_VIBRANCY,
         ConfigKeys::LIGHT_VIBRANCY_DARKNESS, ConfigKeys::LIGHT_ADAPTIVE_DIM,
-        ConfigKeys::LIGHT_ADAPTIVE_BOOST);
+        ConfigKeys::LIGHT_ADAPTIVE_BOOST, ConfigKeys::LIGHT_BACKDROP_FPS);
 }
 
 // ── Preset keyword parsing ───────────────────────────────────────────────────
@@ -202,6 +230,7 @@ static bool setPresetIntField(SPresetValues& values, std::string_view key, std::
 
     if (key == "blur_iterations") { values.blurIterations = parsed; return true; }
     if (key == "tint_color")      { values.tintColor = parsed; return true; }
+    if (key == "backdrop_fps")    { values.backdropFps = parsed; return true; }
     return false;
 }
 
@@ -230,6 +259,7 @@ static void mergePresetValues(SPresetValues& target, const SPresetValues& overri
     mergeFloat(target.vibrancyDarkness, overrides.vibrancyDarkness);
     mergeFloat(target.adaptiveDim, overrides.adaptiveDim);
     mergeFloat(target.adaptiveBoost, overrides.adaptiveBoost);
+    mergeInt(target.backdropFps, overrides.backdropFps);
 }
 
 Hyprlang::CParseResult handlePresetKeyword(const char* /*command*/, const char* value) {
@@ -327,6 +357,8 @@ void commitPendingPresets() {
 
     g_pGlobalState->customPresets = std::move(merged);
     s_pendingPresets.clear();
+
+    flattenPresets();
 }
 
 void validateConfig() {
@@ -336,9 +368,9 @@ void validateConfig() {
 
     if (config.defaultTheme) {
         const char* theme = *config.defaultTheme;
-        if (!theme || (std::string_view(theme) != "dark" && std::string_view(theme) != "light")) {
+        if (!theme || (std::string_view(theme) != "dark" && std::string_view(theme) != "light" && std::string_view(theme) != "auto")) {
             HyprlandAPI::addNotificationV2(PHANDLE, {
-                {"text", std::string("[hyprglass] Invalid default_theme '") + (theme ? theme : "(null)") + "', expected 'dark' or 'light'. Falling back to 'dark'."},
+                {"text", std::string("[hyprglass] Invalid default_theme '") + (theme ? theme : "(null)") + "', expected 'dark', 'light' or 'auto'. Falling back to 'dark'."},
                 {"time", (uint64_t)5000},
                 {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
             });
@@ -358,104 +390,196 @@ void validateConfig() {
             }
         }
     }
+
+    const auto& lod = config.lod;
+    if (lod.lowArea && lod.mediumArea && **lod.lowArea > **lod.mediumArea) {
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::string("[hyprglass] lod_low_area is above lod_medium_area. Windows between the two skip the medium tier.")},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
+        });
+    }
+    if (lod.lowVisible && lod.mediumVisible && **lod.lowVisible > **lod.mediumVisible) {
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::string("[hyprglass] lod_low_visible is above lod_medium_visible. Windows between the two skip the medium tier.")},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
+        });
+    }
+
+    for (const auto& error : g_pGlobalState->presetTable.inheritanceErrors) {
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::string("[hyprglass] ") + error + ". Inheritance stops at that point."},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
+        });
+    }
 }
 
-// ── Preset-aware resolution ──────────────────────────────────────────────────
+// ── Preset flattening ────────────────────────────────────────────────────────
+
+// Like mergePresetValues, but lower-priority: only fills fields still at sentinel
+static void fillUnsetPresetValues(SPresetValues& target, const SPresetValues& fallback) {
+    auto fillFloat = [](float& dst, float src) { if (dst < 0.0f && src >= 0.0f) dst = src; };
+    auto fillInt   = [](int64_t& dst, int64_t src) { if (dst < 0 && src >= 0) dst = src; };
+
+    fillFloat(target.blurStrength, fallback.blurStrength);
+    fillInt(target.blurIterations, fallback.blurIterations);
+    fillFloat(target.refractionStrength, fallback.refractionStrength);
+    fillFloat(target.chromaticAberration, fallback.chromaticAberration);
+    fillFloat(target.fresnelStrength, fallback.fresnelStrength);
+    fillFloat(target.specularStrength, fallback.specularStrength);
+    fillFloat(target.glassOpacity, fallback.glassOpacity);
+    fillFloat(target.edgeThickness, fallback.edgeThickness);
+    fillInt(target.tintColor, fallback.tintColor);
+    fillFloat(target.lensDistortion, fallback.lensDistortion);
+    fillFloat(target.brightness, fallback.brightness);
+    fillFloat(target.contrast, fallback.contrast);
+    fillFloat(target.saturation, fallback.saturation);
+    fillFloat(target.vibrancy, fallback.vibrancy);
+    fillFloat(target.vibrancyDarkness, fallback.vibrancyDarkness);
+    fillFloat(target.adaptiveDim, fallback.adaptiveDim);
+    fillFloat(target.adaptiveBoost, fallback.adaptiveBoost);
+    fillInt(target.backdropFps, fallback.backdropFps);
+}
 
-static float resolvePresetFloatImpl(
-    const std::string& presetName, bool isDark,
-    float SPresetValues::* presetField,
-    Hyprlang::FLOAT* const* SOverridableConfig::* configField,
-    const SPluginConfig& config,
+// Snapshot a Hyprlang config layer as plain values (sentinel where unavailable)
+static SPresetValues readConfigLayer(const SOverridableConfig& layer) {
+    SPresetValues values;
+
+    auto readFloat = [](float& dst, Hyprlang::FLOAT* const* ptr) { if (ptr && *ptr) dst = static_cast<float>(**ptr); };
+    auto readInt   = [](int64_t& dst, Hyprlang::INT* const* ptr) { if (ptr && *ptr) dst = **ptr; };
+
+    readFloat(values.blurStrength, layer.blurStrength);
+    readInt(values.blurIterations, layer.blurIterations);
+    readFloat(values.refractionStrength, layer.refractionStrength);
+    readFloat(values.chromaticAberration, layer.chromaticAberration);
+    readFloat(values.fresnelStrength, layer.fresnelStrength);
+    readFloat(values.specularStrength, layer.specularStrength);
+    readFloat(values.glassOpacity, layer.glassOpacity);
+    readFloat(values.edgeThickness, layer.edgeThickness);
+    readInt(values.tintColor, layer.tintColor);
+    readFloat(values.lensDistortion, layer.lensDistortion);
+    readFloat(values.brightness, layer.brightness);
+    readFloat(values.contrast, layer.contrast);
+    readFloat(values.saturation, layer.saturation);
+    readFloat(values.vibrancy, layer.vibrancy);
+    readFloat(values.vibrancyDarkness, layer.vibrancyDarkness);
+    readFloat(values.adaptiveDim, layer.adaptiveDim);
+    readFloat(values.adaptiveBoost, layer.adaptiveBoost);
+    readInt(values.backdropFps, layer.backdropFps);
+
+    return values;
+}
+
+static SPresetValues themeDefaultsAsValues(const SThemeDefaults& defaults) {
+    SPresetValues values;
+    values.brightness       = defaults.brightness;
+    values.contrast         = defaults.contrast;
+    values.saturation       = defaults.saturation;
+    values.vibrancy         = defaults.vibrancy;
+    values.vibrancyDarkness = defaults.vibrancyDarkness;
+    values.adaptiveDim      = defaults.adaptiveDim;
+    values.adaptiveBoost    = defaults.adaptiveBoost;
+    return values;
+}
+
+// Walk `inherits` from a preset, stopping at unknown parents, cycles and the depth limit
+static std::vector<const SCustomPreset*> collectInheritanceChain(
+    const SCustomPreset& start,
     const std::unordered_map<std::string, SCustomPreset>& customPresets,
-    float hardcodedDefault, int depth
+    std::vector<std::string>& errors
 ) {
-    if (depth < MAX_PRESET_INHERITANCE_DEPTH) {
-        if (auto it = customPresets.find(presetName); it != customPresets.end()) {
-            const auto& preset = it->second;
-
-            const auto& themeVariant = isDark ? preset.dark : preset.light;
-            if (themeVariant.*presetField >= 0.0f) return themeVariant.*presetField;
+    std::vector<const SCustomPreset*> chain{&start};
+
+    for (const auto* current = &start; !current->inherits.empty();) {
+        const auto it = customPresets.find(current->inherits);
+        if (it == customPresets.end()) {
+            // Reported once, by the preset that names the unknown parent
+            if (current == &start)
+                errors.push_back(std::format("preset '{}' inherits unknown preset '{}'", start.name, current->inherits));
+            break;
+        }
 
-            if (preset.shared.*presetField >= 0.0f) return preset.shared.*presetField;
+        const auto* parent = &it->second;
+        if (std::ranges::find(chain, parent) != chain.end()) {
+            // Every member of a cycle sees it; only the smallest name reports it
+            const bool startInCycle = parent == &start;
+            const bool smallestName = std::ranges::none_of(chain, [&](const auto* p) { return p->name < start.name; });
+            if (startInCycle && smallestName)
+                errors.push_back(std::format("preset '{}' has an inheritance cycle", start.name));
+            break;
+        }
 
-            if (!preset.inherits.empty())
-                return resolvePresetFloatImpl(preset.inherits, isDark, presetField, configField,
-                                             config, customPresets, hardcodedDefault, depth + 1);
+        if (chain.size() >= static_cast<size_t>(MAX_PRESET_INHERITANCE_DEPTH)) {
+            errors.push_back(std::format("preset '{}' exceeds the maximum inheritance depth of {}", start.name, MAX_PRESET_INHERITANCE_DEPTH));
+            break;
         }
-    }
 
-    // Built-in theme override
-    const auto& themeConfig = isDark ? config.dark : config.light;
-    if (auto ptr = themeConfig.*configField; ptr && *ptr) {
-        const float themeValue = static_cast<float>(**ptr);
-        if (themeValue >= 0.0f) return themeValue;
+        chain.push_back(parent);
+        current = parent;
     }
 
-    // Global
-    if (auto ptr = config.global.*configField; ptr && *ptr) {
-        const float globalValue = static_cast<float>(**ptr);
-        if (globalValue >= 0.0f) return globalValue;
+    return chain;
+}
+
+static SPresetValues flattenVariant(const std::vector<const SCustomPreset*>& chain, bool isDark,
+                                    const SPresetValues& themeLayer, const SPresetValues& globalLayer) {
+    SPresetValues values;
+
+    for (const auto* preset : chain) {
+        fillUnsetPresetValues(values, isDark ? preset->dark : preset->light);
+        fillUnsetPresetValues(values, preset->shared);
     }
 
-    return hardcodedDefault;
-}
+    fillUnsetPresetValues(values, themeLayer);
+    fillUnsetPresetValues(values, globalLayer);
+    fillUnsetPresetValues(values, themeDefaultsAsValues(isDark ? DARK_THEME_DEFAULTS : LIGHT_THEME_DEFAULTS));
 
-float resolvePresetFloat(
-    const SResolveContext& context,
-    float SPresetValues::* presetField,
-    Hyprlang::FLOAT* const* SOverridableConfig::* configField,
-    float hardcodedDefault
-) {
-    return resolvePresetFloatImpl(context.presetName, context.isDark, presetField, configField,
-                                 context.config, context.customPresets, hardcodedDefault, 0);
+    return values;
 }
 
-static int64_t resolvePresetIntImpl(
-    const std::string& presetName, bool isDark,
-    int64_t SPresetValues::* presetField,
-    Hyprlang::INT* const* SOverridableConfig::* configField,
-    const SPluginConfig& config,
-    const std::unordered_map<std::string, SCustomPreset>& customPresets,
-    int64_t hardcodedDefault, int depth
-) {
-    if (depth < MAX_PRESET_INHERITANCE_DEPTH) {
-        if (auto it = customPresets.find(presetName); it != customPresets.end()) {
-            const auto& preset = it->second;
+void flattenPresets() {
+    if (!g_pGlobalState) return;
 
-            const auto& themeVariant = isDark ? preset.dark : preset.light;
-            if (themeVariant.*presetField >= 0) return themeVariant.*presetField;
+    const auto& config        = g_pGlobalState->config;
+    const auto& customPresets = g_pGlobalState->customPresets;
+    auto&       table         = g_pGlobalState->presetTable;
 
-            if (preset.shared.*presetField >= 0) return preset.shared.*presetField;
+    const auto globalLayer = readConfigLayer(config.global);
+    const auto darkLayer   = readConfigLayer(config.dark);
+    const auto lightLayer  = readConfigLayer(config.light);
 
-            if (!preset.inherits.empty())
-                return resolvePresetIntImpl(preset.inherits, isDark, presetField, configField,
-                                           config, customPresets, hardcodedDefault, depth + 1);
-        }
-    }
+    table.presets.clear();
+    table.ids.clear();
+    table.inheritanceErrors.clear();
 
-    // Built-in theme override
-    const auto& themeConfig = isDark ? config.dark : config.light;
-    if (auto ptr = themeConfig.*configField; ptr && *ptr) {
-        const int64_t themeValue = **ptr;
-        if (themeValue >= 0) return themeValue;
-    }
+    const std::vector<const SCustomPreset*> noChain;
+    table.presets.push_back({
+        flattenVariant(noChain, true, darkLayer, globalLayer),
+        flattenVariant(noChain, false, lightLayer, globalLayer),
+    });
 
-    // Global
-    if (auto ptr = config.global.*configField; ptr && *ptr) {
-        const int64_t globalValue = **ptr;
-        if (globalValue >= 0) return globalValue;
+    for (const auto& [name, preset] : customPresets) {
+        const auto chain = collectInheritanceChain(preset, customPresets, table.inheritanceErrors);
+
+        table.ids.emplace(name, static_cast<PresetId>(table.presets.size()));
+        table.presets.push_back({
+            flattenVariant(chain, true, darkLayer, globalLayer),
+            flattenVariant(chain, false, lightLayer, globalLayer),
+        });
     }
+}
 
-    return hardcodedDefault;
+PresetId findPresetId(std::string_view presetName) {
+    const auto& ids = g_pGlobalState->presetTable.ids;
+    if (auto it = ids.find(presetName); it != ids.end())
+        return it->second;
+    return DEFAULT_PRESET_ID;
 }
 
-int64_t resolvePresetInt(
-    const SResolveContext& context,
-    int64_t SPresetValues::* presetField,
-    Hyprlang::INT* const* SOverridableConfig::* configField,
-    int64_t hardcodedDefault
-) {
-    return resolvePresetIntImpl(context.presetName, context.isDark, presetField, configField,
-                                context.config, context.customPresets, hardcodedDefault, 0);
+const SPresetValues& resolvePresetValues(PresetId presetId, bool isDark) {
+    const auto& presets = g_pGlobalState->presetTable.presets;
+    const auto& preset  = presets[presetId < presets.size() ? presetId : DEFAULT_PRESET_ID];
+    return isDark ? preset.dark : preset.light;
 }
@@ -1,15 +1,18 @@
 #pragma once
 
 #include <hyprland/src/plugins/PluginAPI.hpp>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <unordered_map>
+#include <vector>
 
 inline constexpr std::string_view CONFIG_PREFIX = "plugin:hyprglass:";
 
 // Window tags for theme and preset selection
 inline constexpr std::string_view TAG_THEME_PREFIX  = "hyprglass_theme_";
 inline constexpr std::string_view TAG_PRESET_PREFIX = "hyprglass_preset_";
+inline constexpr std::string_view TAG_LOD_PREFIX    = "hyprglass_lod_";
 
 // Sentinel: "not set by user, inherit from parent layer"
 inline constexpr Hyprlang::FLOAT SENTINEL_FLOAT = -1.0;
@@ -17,6 +20,13 @@ inline constexpr Hyprlang::INT   SENTINEL_INT   = -1;
 
 inline constexpr int MAX_PRESET_INHERITANCE_DEPTH = 8;
 
+// Theme selection: fixed, or picked from the backdrop luminance (CBackdropProbe)
+enum eThemeMode : uint8_t {
+    THEME_DARK = 0,
+    THEME_LIGHT,
+    THEME_AUTO,
+};
+
 namespace ConfigKeys {
 
 // Global-only
@@ -24,6 +34,23 @@ inline constexpr auto ENABLED        = "plugin:hyprglass:enabled";
 inline constexpr auto DEFAULT_THEME  = "plugin:hyprglass:default_theme";
 inline constexpr auto DEFAULT_PRESET = "plugin:hyprglass:default_preset";
 
+// Global-only — level of detail
+inline constexpr auto LOD_ENABLED        = "plugin:hyprglass:lod_enabled";
+inline constexpr auto LOD_MEDIUM_AREA    = "plugin:hyprglass:lod_medium_area";
+inline constexpr auto LOD_LOW_AREA       = "plugin:hyprglass:lod_low_area";
+inline constexpr auto LOD_MEDIUM_VISIBLE = "plugin:hyprglass:lod_medium_visible";
+inline constexpr auto LOD_LOW_VISIBLE    = "plugin:hyprglass:lod_low_visible";
+inline constexpr auto UNIFORM_BACKDROP_THRESHOLD = "plugin:hyprglass:uniform_backdrop_threshold";
+inline constexpr auto STOCHASTIC_BLUR            = "plugin:hyprglass:stochastic_blur";
+
+// Global-only — GPU memory
+inline constexpr auto VRAM_BUDGET_MB       = "plugin:hyprglass:vram_budget_mb";
+inline constexpr auto IDLE_RELEASE_SECONDS = "plugin:hyprglass:idle_release_seconds";
+inline constexpr auto BACKDROP_CACHE       = "plugin:hyprglass:backdrop_cache";
+
+// Global-only — diagnostics
+inline constexpr auto TELEMETRY = "plugin:hyprglass:telemetry";
+
 // Preset keyword, registered as unscoped because Hyprlang does not dispatch
 // scoped keyword handlers inside the plugin special category.
 inline constexpr auto PRESET_KEYWORD = "preset";
@@ -46,6 +73,7 @@ inline constexpr auto VIBRANCY             = "plugin:hyprglass:vibrancy";
 inline constexpr auto VIBRANCY_DARKNESS    = "plugin:hyprglass:vibrancy_darkness";
 inline constexpr auto ADAPTIVE_DIM          = "plugin:hyprglass:adaptive_dim";
 inline constexpr auto ADAPTIVE_BOOST        = "plugin:hyprglass:adaptive_boost";
+inline constexpr auto BACKDROP_FPS          = "plugin:hyprglass:backdrop_fps";
 
 // Overridable — dark theme overrides
 inline constexpr auto DARK_BLUR_STRENGTH        = "plugin:hyprglass:dark:blur_strength";
@@ -65,6 +93,7 @@ inline constexpr auto DARK_VIBRANCY             = "plugin:hyprglass:dark:vibranc
 inline constexpr auto DARK_VIBRANCY_DARKNESS    = "plugin:hyprglass:dark:vibrancy_darkness";
 inline constexpr auto DARK_ADAPTIVE_DIM          = "plugin:hyprglass:dark:adaptive_dim";
 inline constexpr auto DARK_ADAPTIVE_BOOST        = "plugin:hyprglass:dark:adaptive_boost";
+inline constexpr auto DARK_BACKDROP_FPS          = "plugin:hyprglass:dark:backdrop_fps";
 
 // Overridable — light theme overrides
 inline constexpr auto LIGHT_BLUR_STRENGTH        = "plugin:hyprglass:light:blur_strength";
@@ -84,6 +113,7 @@ inline constexpr auto LIGHT_VIBRANCY             = "plugin:hyprglass:light:vibra
 inline constexpr auto LIGHT_VIBRANCY_DARKNESS    = "plugin:hyprglass:light:vibrancy_darkness";
 inline constexpr auto LIGHT_ADAPTIVE_DIM          = "plugin:hyprglass:light:adaptive_dim";
 inline constexpr auto LIGHT_ADAPTIVE_BOOST        = "plugin:hyprglass:light:adaptive_boost";
+inline constexpr auto LIGHT_BACKDROP_FPS          = "plugin:hyprglass:light:backdrop_fps";
 
 } // namespace ConfigKeys
 
@@ -106,6 +136,7 @@ struct SOverridableConfig {
     Hyprlang::FLOAT* const* vibrancyDarkness    = nullptr;
     Hyprlang::FLOAT* const* adaptiveDim         = nullptr;
     Hyprlang::FLOAT* const* adaptiveBoost       = nullptr;
+    Hyprlang::INT* const*   backdropFps         = nullptr;
 };
 
 // Plain values for a user-defined preset layer (all sentinel = not set → inherit)
@@ -127,6 +158,9 @@ struct SPresetValues {
     float   vibrancyDarkness   = static_cast<float>(SENTINEL_FLOAT);
     float   adaptiveDim        = static_cast<float>(SENTINEL_FLOAT);
     float   adaptiveBoost      = static_cast<float>(SENTINEL_FLOAT);
+    int64_t backdropFps        = SENTINEL_INT;
+
+    bool operator==(const SPresetValues&) const = default;
 };
 
 struct SCustomPreset {
@@ -137,36 +171,68 @@ struct SCustomPreset {
     SPresetValues light;
 };
 
+struct SLodConfig {
+    Hyprlang::INT* const*   enabled                  = nullptr;
+    Hyprlang::FLOAT* const* mediumArea               = nullptr;
+    Hyprlang::FLOAT* const* lowArea                  = nullptr;
+    Hyprlang::FLOAT* const* mediumVisible            = nullptr;
+    Hyprlang::FLOAT* const* lowVisible               = nullptr;
+    Hyprlang::FLOAT* const* uniformBackdropThreshold = nullptr;
+    Hyprlang::INT* const*   stochasticBlur           = nullptr;
+};
+
 struct SPluginConfig {
-    Hyprlang::INT* const*   enabled       = nullptr;
-    Hyprlang::STRING const*  defaultTheme  = nullptr;
-    Hyprlang::STRING const*  defaultPreset = nullptr;
+    Hyprlang::INT* const*   enabled            = nullptr;
+    Hyprlang::STRING const*  defaultTheme       = nullptr;
+    Hyprlang::STRING const*  defaultPreset      = nullptr;
+    Hyprlang::INT* const*   vramBudgetMb       = nullptr;
+    Hyprlang::INT* const*   idleReleaseSeconds = nullptr;
+    Hyprlang::INT* const*   backdropCache      = nullptr;
+    Hyprlang::INT* const*   telemetry          = nullptr;
+
+    SLodConfig lod;
 
     SOverridableConfig global;
     SOverridableConfig dark;
     SOverridableConfig light;
 };
 
-// Context for preset-aware value resolution
-struct SResolveContext {
-    const std::string&                                    presetName;
-    bool                                                  isDark;
-    const SPluginConfig&                                  config;
-    const std::unordered_map<std::string, SCustomPreset>& customPresets;
+// Index into the flattened preset table. DEFAULT_PRESET_ID is the implicit
+// "no preset" chain (built-in theme → global → hardcoded), also used for
+// unknown preset names.
+using PresetId = uint16_t;
+inline constexpr PresetId DEFAULT_PRESET_ID = 0;
+
+// Fully resolved values of one preset: every field has already been through
+// preset chain → built-in theme override → global → hardcoded default.
+struct SResolvedPreset {
+    SPresetValues dark;
+    SPresetValues light;
 };
 
-// Preset-aware resolution: preset chain → built-in theme → global → hardcoded
-[[nodiscard]] float resolvePresetFloat(
-    const SResolveContext& context,
-    float SPresetValues::* presetField,
-    Hyprlang::FLOAT* const* SOverridableConfig::* configField,
-    float hardcodedDefault = static_cast<float>(SENTINEL_FLOAT));
-
-[[nodiscard]] int64_t resolvePresetInt(
-    const SResolveContext& context,
-    int64_t SPresetValues::* presetField,
-    Hyprlang::INT* const* SOverridableConfig::* configField,
-    int64_t hardcodedDefault = SENTINEL_INT);
+struct SStringHash {
+    using is_transparent = void;
+    [[nodiscard]] size_t operator()(std::string_view str) const noexcept { return std::hash<std::string_view>{}(str); }
+};
+
+// Flattened presets, rebuilt when presets are committed (config reload) or a
+// config layer changes through `hyprctl keyword`, never while drawing
+struct SPresetTable {
+    std::vector<SResolvedPreset>                                           presets; // indexed by PresetId
+    std::unordered_map<std::string, PresetId, SStringHash, std::equal_to<>> ids;
+
+    // Inheritance problems found while flattening, reported once by validateConfig()
+    std::vector<std::string> inheritanceErrors;
+};
+
+// Rebuild the flattened preset table from the committed presets and current config
+void flattenPresets();
+
+// Preset name → table index (DEFAULT_PRESET_ID when unknown)
+[[nodiscard]] PresetId findPresetId(std::string_view presetName);
+
+// Draw-time resolution: a table lookup
+[[nodiscard]] const SPresetValues& resolvePresetValues(PresetId presetId, bool isDark);
 
 void registerConfig(HANDLE handle);
 void initConfigPointers(HANDLE handle, SPluginConfig& config);
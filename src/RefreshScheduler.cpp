@@ -0,0 +1,61 @@
+#include "RefreshScheduler.hpp"
+#include "GlassDecoration.hpp"
+
+#include <algorithm>
+#include <hyprland/src/managers/eventLoop/EventLoopManager.hpp>
+
+void CRefreshScheduler::schedule(const WP<CGlassDecoration>& decoration, TimePoint when) {
+    const auto pending = std::ranges::find_if(m_pending, [&decoration](const auto& entry) { return entry.decoration == decoration; });
+    if (pending != m_pending.end()) {
+        if (pending->when <= when)
+            return;
+        pending->when = when;
+    } else
+        m_pending.push_back({decoration, when});
+
+    arm();
+}
+
+void CRefreshScheduler::onTimer() {
+    const auto now = std::chrono::steady_clock::now();
+
+    // Collected first: a refresh may schedule again
+    std::vector<WP<CGlassDecoration>> due;
+    std::erase_if(m_pending, [&](const auto& entry) {
+        if (entry.when > now && !entry.decoration.expired())
+            return false;
+        due.push_back(entry.decoration);
+        return true;
+    });
+
+    for (const auto& decoration : due) {
+        if (const auto locked = decoration.lock())
+            locked->refreshDeferredBackdrop();
+    }
+
+    arm();
+}
+
+void CRefreshScheduler::arm() {
+    if (m_pending.empty()) {
+        if (m_timer)
+            m_timer->updateTimeout(std::nullopt);
+        return;
+    }
+
+    if (!m_timer) {
+        m_timer = makeShared<CEventLoopTimer>(std::nullopt, [this](SP<CEventLoopTimer>, void*) { onTimer(); }, nullptr);
+        g_pEventLoopManager->addTimer(m_timer);
+    }
+
+    const auto next = std::ranges::min_element(m_pending, {}, &SPending::when)->when;
+    m_timer->updateTimeout(std::max(next - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero()));
+}
+
+void CRefreshScheduler::release() {
+    if (m_timer) {
+        g_pEventLoopManager->removeTimer(m_timer);
+        m_timer.reset();
+    }
+    m_pending.clear();
+}
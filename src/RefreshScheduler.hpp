@@ -0,0 +1,35 @@
+#pragma once
+
+#include <hyprland/src/managers/eventLoop/EventLoopTimer.hpp>
+
+#include <chrono>
+#include <vector>
+
+class CGlassDecoration;
+
+// Wakes glass whose backdrop refresh was put off (backdrop_fps). A skipped
+// refresh leaves no damage behind: without a wake-up, the last change behind
+// a window would only reach its glass with the next unrelated frame. One
+// event loop timer serves every decoration, armed for the earliest deadline.
+class CRefreshScheduler {
+  public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    // Calls refreshDeferredBackdrop() on the decoration at `when`; an earlier
+    // request for the same decoration stands
+    void schedule(const WP<CGlassDecoration>& decoration, TimePoint when);
+
+    void release();
+
+  private:
+    struct SPending {
+        WP<CGlassDecoration> decoration;
+        TimePoint            when;
+    };
+
+    std::vector<SPending> m_pending;
+    SP<CEventLoopTimer>   m_timer;
+
+    void onTimer();
+    void arm();
+};
@@ -28,22 +28,24 @@ bool CShaderManager::compileGlassShader() {
         return false;
     }
 
-    const auto program = glassShader->program();
-
-    glassUniforms.refractionStrength  = glGetUniformLocation(program, "refractionStrength");
-    glassUniforms.chromaticAberration = glGetUniformLocation(program, "chromaticAberration");
-    glassUniforms.fresnelStrength     = glGetUniformLocation(program, "fresnelStrength");
-    glassUniforms.specularStrength    = glGetUniformLocation(program, "specularStrength");
-    glassUniforms.glassOpacity        = glGetUniformLocation(program, "glassOpacity");
-    glassUniforms.edgeThickness       = glGetUniformLocation(program, "edgeThickness");
-    glassUniforms.uvPadding           = glGetUniformLocation(program, "uvPadding");
-    glassUniforms.tintColor           = glGetUniformLocation(program, "tintColor");
-    glassUniforms.tintAlpha           = glGetUniformLocation(program, "tintAlpha");
-    glassUniforms.lensDistortion      = glGetUniformLocation(program, "lensDistortion");
-    glassUniforms.saturation          = glGetUniformLocation(program, "saturation");
-    glassUniforms.vibrancyDarkness    = glGetUniformLocation(program, "vibrancyDarkness");
-    glassUniforms.adaptiveDim         = glGetUniformLocation(program, "adaptiveDim");
-    glassUniforms.adaptiveBoost       = glGetUniformLocation(program, "adaptiveBoost");
+    GlassPasses::queryUniforms(glassShader->program(), glassUniforms);
+
+    return true;
+}
+
+bool CShaderManager::compileGlassInteriorShader() {
+    if (!glassInteriorShader->createProgram(
+            g_pHyprOpenGL->m_shaders->TEXVERTSRC,
+            loadShaderSource("liquidglass_interior.frag"),
+            true
+        )) {
+        HyprlandAPI::addNotification(PHANDLE,
+            std::format("[{}] Failed to compile glass interior shader", PLUGIN_NAME),
+            CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        return false;
+    }
+
+    GlassPasses::queryUniforms(glassInteriorShader->program(), glassInteriorUniforms);
 
     return true;
 }
@@ -60,10 +62,41 @@ bool CShaderManager::compileBlurShader() {
         return false;
     }
 
-    const auto program = blurShader->program();
+    GlassPasses::queryUniforms(blurShader->program(), blurUniforms);
 
-    blurUniforms.direction = glGetUniformLocation(program, "direction");
-    blurUniforms.radius    = glGetUniformLocation(program, "blurRadius");
+    return true;
+}
+
+bool CShaderManager::compileStochasticBlurShader() {
+    if (!stochasticBlurShader->createProgram(
+            g_pHyprOpenGL->m_shaders->TEXVERTSRC,
+            loadShaderSource("stochasticblur.frag"),
+            true
+        )) {
+        HyprlandAPI::addNotification(PHANDLE,
+            std::format("[{}] Failed to compile stochastic blur shader", PLUGIN_NAME),
+            CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        return false;
+    }
+
+    GlassPasses::queryUniforms(stochasticBlurShader->program(), stochasticBlurUniforms);
+
+    return true;
+}
+
+bool CShaderManager::compileBackdropStatsShader() {
+    if (!backdropStatsShader->createProgram(
+            g_pHyprOpenGL->m_shaders->TEXVERTSRC,
+            loadShaderSource("backdropstats.frag"),
+            true
+        )) {
+        HyprlandAPI::addNotification(PHANDLE,
+            std::format("[{}] Failed to compile backdrop statistics shader", PLUGIN_NAME),
+            CHyprColor{1.0, 0.2, 0.2, 1.0}, 5000);
+        return false;
+    }
+
+    GlassPasses::queryUniforms(backdropStatsShader->program(), backdropStatsUniforms);
 
     return true;
 }
@@ -75,14 +108,29 @@ void CShaderManager::initializeIfNeeded() {
     if (!compileGlassShader())
         return;
 
+    if (!compileGlassInteriorShader())
+        return;
+
     if (!compileBlurShader())
         return;
 
+    if (!compileStochasticBlurShader())
+        return;
+
+    if (!compileBackdropStatsShader())
+        return;
+
+    // Program names may be reused by the new programs
+    g_pGlobalState->glState.forgetUniforms();
     m_initialized = true;
 }
 
 void CShaderManager::destroy() noexcept {
     glassShader->destroy();
+    glassInteriorShader->destroy();
     blurShader->destroy();
+    stochasticBlurShader->destroy();
+    backdropStatsShader->destroy();
+    g_pGlobalState->glState.forgetUniforms();
     m_initialized = false;
 }
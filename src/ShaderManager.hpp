@@ -1,31 +1,11 @@
 #pragma once
 
+#include "GlassPasses.hpp"
+
 #include <GLES3/gl32.h>
 #include <hyprland/src/render/Shader.hpp>
 #include <string>
 
-struct SGlassUniforms {
-    GLint refractionStrength = -1;
-    GLint chromaticAberration = -1;
-    GLint fresnelStrength = -1;
-    GLint specularStrength = -1;
-    GLint glassOpacity = -1;
-    GLint edgeThickness = -1;
-    GLint uvPadding = -1;
-    GLint tintColor = -1;
-    GLint tintAlpha = -1;
-    GLint lensDistortion = -1;
-    GLint saturation = -1;
-    GLint vibrancyDarkness = -1;
-    GLint adaptiveDim = -1;
-    GLint adaptiveBoost = -1;
-};
-
-struct SBlurUniforms {
-    GLint direction = -1;
-    GLint radius    = -1;
-};
-
 class CShaderManager {
   public:
     [[nodiscard]] bool isInitialized() const noexcept { return m_initialized; }
@@ -33,16 +13,31 @@ class CShaderManager {
     void initializeIfNeeded();
     void destroy() noexcept;
 
-    SP<CShader>    glassShader = makeShared<CShader>();
-    SGlassUniforms glassUniforms;
+    SP<CShader>                 glassShader = makeShared<CShader>();
+    GlassPasses::SGlassUniforms glassUniforms;
+
+    // Interior of the window, past the bezel: tone mapping only, no SDF/refraction
+    SP<CShader>                 glassInteriorShader = makeShared<CShader>();
+    GlassPasses::SGlassUniforms glassInteriorUniforms;
+
+    SP<CShader>                blurShader = makeShared<CShader>();
+    GlassPasses::SBlurUniforms blurUniforms;
+
+    // Single-pass estimate of the blur while a window moves (stochastic_blur)
+    SP<CShader>                          stochasticBlurShader = makeShared<CShader>();
+    GlassPasses::SStochasticBlurUniforms stochasticBlurUniforms;
 
-    SP<CShader>    blurShader = makeShared<CShader>();
-    SBlurUniforms  blurUniforms;
+    // Reduction input of CBackdropProbe
+    SP<CShader>                         backdropStatsShader = makeShared<CShader>();
+    GlassPasses::SBackdropStatsUniforms backdropStatsUniforms;
 
   private:
     bool m_initialized = false;
 
     [[nodiscard]] static std::string loadShaderSource(const char* fileName);
     [[nodiscard]] bool compileGlassShader();
+    [[nodiscard]] bool compileGlassInteriorShader();
     [[nodiscard]] bool compileBlurShader();
+    [[nodiscard]] bool compileStochasticBlurShader();
+    [[nodiscard]] bool compileBackdropStatsShader();
 };
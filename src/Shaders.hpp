@@ -22,35 +22,27 @@ precision highp float;
  * 2. Chromatic aberration (per-channel refraction scale)
  * 3. Edge raw-texture blend for vivid color pickup
  * 4. Subtle center dome lens magnification
- * 5. Frosted tint (brightness boost + desaturation)
- * 6. Configurable color tint overlay
- * 7. Fresnel edge glow
- * 8. Specular highlight (top)
- * 9. Inner shadow (bottom rim)
+ * 5. Frosted tint and color tint overlay (baked 3D LUT)
+ * 6. Fresnel edge glow
+ * 7. Specular highlight (top)
+ * 8. Inner shadow (bottom rim)
  */
 
 uniform sampler2D tex;
+uniform highp sampler2D edgeField; // RG32F: (sdf, edgeProximity)
+uniform int edgeFieldSize;
 uniform vec2 fullSize;
-uniform float radius;
 uniform vec2 uvPadding;
+uniform float blurRadius;
+uniform vec2 blurDirection;
 
 uniform float refractionStrength;
 uniform float chromaticAberration;
 uniform float fresnelStrength;
 uniform float specularStrength;
 uniform float glassOpacity;
-uniform float edgeThickness;
-uniform vec3 tintColor;
-uniform float tintAlpha;
 uniform float lensDistortion;
-uniform float brightness;
-uniform float contrast;
-uniform float saturation;
-uniform float vibrancy;
-uniform float vibrancyDarkness;
-uniform float adaptiveDim;
-uniform float adaptiveBoost;
-uniform float roundingPower;
+uniform highp sampler3D toneLut;
 
 in vec2 v_texcoord;
 layout(location = 0) out vec4 fragColor;
@@ -63,29 +55,64 @@ vec2 toTexUV(vec2 wuv) {
     return wuv * (1.0 - 2.0 * uvPadding) + uvPadding;
 }
 
+// Final vertical blur pass, fused into sampling: only the refracted sample
+// positions inside the window are blurred, instead of the whole padded rect.
+// Same kernel as gaussianblur.frag; blurRadius == 0 means tex is final.
 vec4 sampleBlurred(vec2 wuv) {
-    vec2 tuv = toTexUV(wuv);
-    return texture(tex, clamp(tuv, 0.001, 0.999));
+    vec2 tuv = clamp(toTexUV(wuv), 0.001, 0.999);
+    if (blurRadius <= 0.0)
+        return texture(tex, tuv);
+
+    float sigma = max(blurRadius / 3.0, 0.001);
+    float invSigma2 = -0.5 / (sigma * sigma);
+    int samples = min(int(ceil(blurRadius)), 8);
+
+    vec4 result = texture(tex, tuv);
+    float totalWeight = 1.0;
+
+    for (int i = 1; i <= samples; i += 2) {
+        float x1 = float(i);
+        float x2 = float(i + 1);
+        float w1 = exp(x1 * x1 * invSigma2);
+        float w2 = (i + 1 <= samples) ? exp(x2 * x2 * invSigma2) : 0.0;
+        float wSum = w1 + w2;
+        if (wSum < 0.0001) continue;
+
+        float offset = (x1 * w1 + x2 * w2) / wSum;
+
+        result += texture(tex, tuv + blurDirection * offset) * wSum;
+        result += texture(tex, tuv - blurDirection * offset) * wSum;
+        totalWeight += 2.0 * wSum;
+    }
+
+    return result / totalWeight;
 }
 
 // ============================================================================
-// SDF
+// TONE MAPPING
+// Frosted tint and tint overlay, baked per preset and theme (CToneLuts): a
+// 33³ grid over the input colour, read at texel centers.
 // ============================================================================
 
-float lpNorm(vec2 v, float p) {
-    return pow(pow(abs(v.x), p) + pow(abs(v.y), p), 1.0 / p);
-}
+const float TONE_LUT_SIZE = 33.0;
 
-float getRoundedBoxSDF(vec2 uv, float r) {
-    vec2 p = (uv - 0.5) * fullSize;
-    vec2 halfSize = fullSize * 0.5;
-    float clampedR = min(r, min(halfSize.x, halfSize.y));
-    vec2 q = abs(p) - halfSize + clampedR;
-    return min(max(q.x, q.y), 0.0) + lpNorm(max(q, 0.0), roundingPower) - clampedR;
+vec3 toneMap(vec3 color) {
+    vec3 coord = clamp(color, 0.0, 1.0) * ((TONE_LUT_SIZE - 1.0) / TONE_LUT_SIZE) + 0.5 / TONE_LUT_SIZE;
+    return texture(toneLut, coord).rgb;
 }
 
-float getCornerSDF(vec2 uv) {
-    return getRoundedBoxSDF(uv, radius);
+// ============================================================================
+// EDGE FIELD
+// Baked per decoration (CEdgeFieldTexture): one corner tile of the rounded-box
+// SDF and of the exponential edge proximity, indexed by the pixel distance to
+// the nearest vertical and horizontal edge. Only regenerated when the window
+// size, corner radius, rounding power or edge thickness change.
+// ============================================================================
+
+vec2 getEdgeField(vec2 uv) {
+    vec2 edgeDistPx = (0.5 - abs(uv - 0.5)) * fullSize;
+    ivec2 texel = min(ivec2(edgeDistPx), ivec2(edgeFieldSize - 1));
+    return texelFetch(edgeField, texel, 0).rg;
 }
 
 // ============================================================================
@@ -108,7 +135,8 @@ vec2 refractionDir(vec2 uv) {
 
 void main() {
     vec2 uv = v_texcoord;
-    float cornerSdf = getCornerSDF(uv);
+    vec2 field = getEdgeField(uv);
+    float cornerSdf = field.x;
 
     if (cornerSdf > 0.0) {
         discard;
@@ -118,14 +146,13 @@ void main() {
     if (cornerAlpha < 0.001) discard;
 
     float minDim = min(fullSize.x, fullSize.y);
-    float bezelWidthPx = edgeThickness * minDim;
 
     // ========================================
     // EDGE PROXIMITY + DIRECTION
-    // edgeProximity: 1.0 at boundary, exponential decay inward
+    // edgeProximity: 1.0 at boundary, exponential decay inward (baked)
     // inwardDir: pixel-space direction toward center (smooth everywhere)
     // ========================================
-    float edgeProximity = exp(cornerSdf / bezelWidthPx);
+    float edgeProximity = field.y;
     vec2 inwardDir = refractionDir(uv);
 
     // ========================================
@@ -183,36 +210,9 @@ void main() {
     }
 
     // ========================================
-    // FROSTED TINT (per-theme tone mapping)
+    // FROSTED TINT + COLOR TINT OVERLAY (per-theme tone mapping)
     // ========================================
-    float blurredLum = dot(color, vec3(0.2126, 0.7152, 0.0722));
-
-    // Frosted desaturation
-    color = mix(vec3(blurredLum), color, saturation);
-
-    // Tight smoothstep range maps the blur-compressed luminance (~0.3-0.7)
-    // to the full [0,1] adaptive range, creating visible per-region differentiation
-    float lumCurve = smoothstep(0.25, 0.55, blurredLum);
-
-    // Dim: multiplicative — effective at darkening bright areas
-    color *= brightness * (1.0 - adaptiveDim * lumCurve);
-
-    // Boost: additive lift — multiplicative can't brighten near-black content
-    color += vec3(adaptiveBoost * (1.0 - lumCurve) * 0.5);
-
-    // Contrast (pivot around midpoint)
-    color = mix(vec3(0.5), color, contrast);
-
-    // Vibrancy (selective saturation boost scaled by existing saturation)
-    float currentLum = dot(color, vec3(0.2126, 0.7152, 0.0722));
-    float sat = max(color.r, max(color.g, color.b)) - min(color.r, min(color.g, color.b));
-    float darkFactor = 1.0 - vibrancyDarkness * (1.0 - blurredLum);
-    color = mix(vec3(currentLum), color, 1.0 + vibrancy * sat * darkFactor);
-
-    // ========================================
-    // COLOR TINT OVERLAY
-    // ========================================
-    color = mix(color, tintColor, tintAlpha);
+    color = toneMap(color);
 
     // ========================================
     // FRESNEL RIM GLOW (edge zone)
@@ -242,6 +242,104 @@ void main() {
 
     fragColor = vec4(color, glassOpacity * cornerAlpha);
 }
+)GLSL"},
+
+    {"liquidglass_interior.frag", R"GLSL(
+#version 300 es
+precision highp float;
+
+/*
+ * Liquid Glass interior — drawn on the inset quad past the bezel ring.
+ *
+ * There the edge proximity of liquidglass.frag has decayed to ~0, so the
+ * SDF, refraction, chromatic aberration, fresnel, specular and inner shadow
+ * terms all vanish. What remains is the dome lens and the frosted tint.
+ */
+
+uniform sampler2D tex;
+uniform vec2 fullSize;
+uniform vec2 uvPadding;
+uniform float blurRadius;
+uniform vec2 blurDirection;
+
+uniform float glassOpacity;
+uniform float lensDistortion;
+uniform highp sampler3D toneLut;
+
+in vec2 v_texcoord;
+layout(location = 0) out vec4 fragColor;
+
+vec2 toTexUV(vec2 wuv) {
+    return wuv * (1.0 - 2.0 * uvPadding) + uvPadding;
+}
+
+// Final vertical blur pass, fused into sampling: only the refracted sample
+// positions inside the window are blurred, instead of the whole padded rect.
+// Same kernel as gaussianblur.frag; blurRadius == 0 means tex is final.
+vec4 sampleBlurred(vec2 wuv) {
+    vec2 tuv = clamp(toTexUV(wuv), 0.001, 0.999);
+    if (blurRadius <= 0.0)
+        return texture(tex, tuv);
+
+    float sigma = max(blurRadius / 3.0, 0.001);
+    float invSigma2 = -0.5 / (sigma * sigma);
+    int samples = min(int(ceil(blurRadius)), 8);
+
+    vec4 result = texture(tex, tuv);
+    float totalWeight = 1.0;
+
+    for (int i = 1; i <= samples; i += 2) {
+        float x1 = float(i);
+        float x2 = float(i + 1);
+        float w1 = exp(x1 * x1 * invSigma2);
+        float w2 = (i + 1 <= samples) ? exp(x2 * x2 * invSigma2) : 0.0;
+        float wSum = w1 + w2;
+        if (wSum < 0.0001) continue;
+
+        float offset = (x1 * w1 + x2 * w2) / wSum;
+
+        result += texture(tex, tuv + blurDirection * offset) * wSum;
+        result += texture(tex, tuv - blurDirection * offset) * wSum;
+        totalWeight += 2.0 * wSum;
+    }
+
+    return result / totalWeight;
+}
+
+// Frosted tint and tint overlay, baked per preset and theme: same as liquidglass.frag
+
+const float TONE_LUT_SIZE = 33.0;
+
+vec3 toneMap(vec3 color) {
+    vec3 coord = clamp(color, 0.0, 1.0) * ((TONE_LUT_SIZE - 1.0) / TONE_LUT_SIZE) + 0.5 / TONE_LUT_SIZE;
+    return texture(toneLut, coord).rgb;
+}
+
+void main() {
+    vec2 uv = v_texcoord;
+    float minDim = min(fullSize.x, fullSize.y);
+
+    // Center dome lens at full strength (lensFade == 1 this far inside)
+    vec2 domeUV = vec2(0.0);
+    if (lensDistortion > 0.001) {
+        vec2 c = (uv - 0.5) * 2.0;
+        vec2 dGrad = vec2(
+            -4.0 * c.x * (1.0 - c.y * c.y),
+            -4.0 * c.y * (1.0 - c.x * c.x)
+        );
+        float lensMaxPx = lensDistortion * minDim * 0.006;
+        domeUV = dGrad * lensMaxPx / fullSize;
+    }
+
+    vec3 color = sampleBlurred(uv + domeUV).rgb;
+
+    // ========================================
+    // FROSTED TINT + COLOR TINT OVERLAY — same as liquidglass.frag
+    // ========================================
+    color = toneMap(color);
+
+    fragColor = vec4(color, glassOpacity);
+}
 )GLSL"},
 
     {"gaussianblur.frag", R"GLSL(
@@ -252,10 +350,23 @@ uniform sampler2D tex;
 uniform vec2 direction; // (1.0/width, 0.0) for horizontal, (0.0, 1.0/height) for vertical
 uniform float blurRadius; // kernel radius in pixels
 
+// Maps the pass's output UV to the input texture. Identity between ping-pong
+// buffers; the first pass reads the padded rect straight out of the monitor
+// framebuffer, clamped to its edge texels.
+uniform vec2 sourceOffset;
+uniform vec2 sourceScale;
+uniform vec4 sourceClamp;
+
 in vec2 v_texcoord;
 layout(location = 0) out vec4 fragColor;
 
+vec4 sampleSource(vec2 uv) {
+    return texture(tex, clamp(uv, sourceClamp.xy, sourceClamp.zw));
+}
+
 void main() {
+    vec2 center = v_texcoord * sourceScale + sourceOffset;
+
     // Compute sigma from radius (covers ~3 sigma)
     float sigma = max(blurRadius / 3.0, 0.001);
     float invSigma2 = -0.5 / (sigma * sigma);
@@ -264,7 +375,7 @@ void main() {
 
     // Center tap
     float w0 = 1.0;
-    vec4 result = texture(tex, v_texcoord) * w0;
+    vec4 result = sampleSource(center) * w0;
     float totalWeight = w0;
 
     // Linear sampling: pair adjacent taps (i, i+1) into a single bilinear fetch.
@@ -281,12 +392,112 @@ void main() {
         // Offset biased toward the heavier weight
         float offset = (x1 * w1 + x2 * w2) / wSum;
 
-        result += texture(tex, v_texcoord + direction * offset) * wSum;
-        result += texture(tex, v_texcoord - direction * offset) * wSum;
+        result += sampleSource(center + direction * offset) * wSum;
+        result += sampleSource(center - direction * offset) * wSum;
         totalWeight += 2.0 * wSum;
     }
 
     fragColor = result / totalWeight;
 }
+)GLSL"},
+
+    {"stochasticblur.frag", R"GLSL(
+#version 300 es
+precision highp float;
+
+uniform sampler2D tex;     // monitor framebuffer
+uniform sampler2D history; // last frame's estimate, same size as the output
+
+// Maps the output UV to the padded rect of the monitor framebuffer, clamped
+// to its edge texels, as in the first pass of gaussianblur.frag
+uniform vec2 sourceOffset;
+uniform vec2 sourceScale;
+uniform vec4 sourceClamp;
+
+uniform vec2 sigma;          // standard deviation of the separable chain, in source UV
+uniform float frame;         // rotates the tap pattern from one frame to the next
+uniform vec2 historyOffset;  // where the same monitor position was last frame, in output UV
+uniform float historyWeight; // 0: no usable history
+
+in vec2 v_texcoord;
+layout(location = 0) out vec4 fragColor;
+
+const int TAPS = 16;
+const float GOLDEN_ANGLE = 2.39996323;
+const float TAU = 6.28318531;
+
+// Interleaved gradient noise: a per-pixel rotation whose error is spread at
+// high frequencies, where the glass and the next frames average it out
+float interleavedGradientNoise(vec2 pixel) {
+    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));
+}
+
+// Monte Carlo estimate of the Gaussian the separable passes converge to:
+// equally weighted taps on a golden-angle spiral whose radii follow the
+// Rayleigh distribution, so the taps are distributed as the Gaussian itself.
+void main() {
+    vec2 center = v_texcoord * sourceScale + sourceOffset;
+
+    float rotation     = TAU * interleavedGradientNoise(gl_FragCoord.xy + 5.588238 * frame);
+    float radialJitter = fract(frame * 0.618034);
+
+    vec4 sum = vec4(0.0);
+    for (int i = 0; i < TAPS; i++) {
+        float u      = (float(i) + radialJitter) / float(TAPS);
+        float radius = sqrt(-2.0 * log(1.0 - 0.999 * u));
+        float angle  = float(i) * GOLDEN_ANGLE + rotation;
+        vec2  uv     = center + radius * vec2(cos(angle), sin(angle)) * sigma;
+        sum += texture(tex, clamp(uv, sourceClamp.xy, sourceClamp.zw));
+    }
+    vec4 estimate = sum / float(TAPS);
+
+    // Reprojected history: the backdrop stays put on the monitor while the window moves
+    vec2 historyUV = v_texcoord + historyOffset;
+    bool inside    = all(greaterThanEqual(historyUV, vec2(0.0))) && all(lessThanEqual(historyUV, vec2(1.0)));
+
+    fragColor = mix(estimate, texture(history, historyUV), inside ? historyWeight : 0.0);
+}
+)GLSL"},
+
+    {"backdropstats.frag", R"GLSL(
+#version 300 es
+precision highp float;
+
+uniform sampler2D tex;
+
+// Maps the output UV to the window's rect of the monitor framebuffer,
+// clamped to its edge texels; footprint is one output texel in source UV.
+uniform vec2 sourceOffset;
+uniform vec2 sourceScale;
+uniform vec4 sourceClamp;
+uniform vec2 footprint;
+
+in vec2 v_texcoord;
+layout(location = 0) out vec4 fragColor;
+
+float luminance(vec3 color) {
+    return dot(color, vec3(0.2126, 0.7152, 0.0722));
+}
+
+// Mean and variance of a 4×4 grid of luminance taps over the texel's
+// footprint. The mip chain then averages both: the mean for the theme, the
+// variance as the amount of detail finer than 1/64 of the window.
+void main() {
+    vec2 center = v_texcoord * sourceScale + sourceOffset;
+
+    float sum = 0.0;
+    float sumSquares = 0.0;
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 4; x++) {
+            vec2 uv = center + footprint * ((vec2(float(x), float(y)) - 1.5) / 4.0);
+            float lum = luminance(texture(tex, clamp(uv, sourceClamp.xy, sourceClamp.zw)).rgb);
+            sum += lum;
+            sumSquares += lum * lum;
+        }
+    }
+
+    float mean = sum / 16.0;
+    fragColor = vec4(mean, max(sumSquares / 16.0 - mean * mean, 0.0), 0.0, 1.0);
+}
 )GLSL"},
 };
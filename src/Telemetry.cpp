@@ -0,0 +1,173 @@
+#include "Telemetry.hpp"
+#include "Globals.hpp"
+
+#include <chrono>
+#include <fcntl.h>
+#include <hyprland/src/helpers/Color.hpp>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ── Segment ──────────────────────────────────────────────────────────────────
+
+CTelemetryPublisher::~CTelemetryPublisher() {
+    close();
+}
+
+bool CTelemetryPublisher::enabled() const noexcept {
+    const auto& telemetry = g_pGlobalState->config.telemetry;
+    return telemetry && **telemetry;
+}
+
+bool CTelemetryPublisher::open() {
+    const auto name = Telemetry::segmentName();
+
+    m_fd = shm_open(name.c_str(), O_CREAT | O_RDWR, S_IRUSR | S_IWUSR);
+    if (m_fd < 0)
+        return false;
+
+    void* mapping = MAP_FAILED;
+    if (ftruncate(m_fd, sizeof(Telemetry::SSegment)) == 0)
+        mapping = mmap(nullptr, sizeof(Telemetry::SSegment), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+
+    if (mapping == MAP_FAILED) {
+        ::close(m_fd);
+        m_fd = -1;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // ftruncate zero-fills: every slot version starts even, nothing published
+    m_segment            = static_cast<Telemetry::SSegment*>(mapping);
+    m_segment->version   = Telemetry::VERSION;
+    m_segment->capacity  = Telemetry::CAPACITY;
+    m_segment->frameSize = sizeof(Telemetry::SFrame);
+    m_segment->published.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_segment->magic = Telemetry::MAGIC;
+
+    m_sequence = 1;
+    m_frame    = {};
+    return true;
+}
+
+void CTelemetryPublisher::close() noexcept {
+    if (m_segment) {
+        // Tells readers still mapping the unlinked segment to look for a new one
+        m_segment->magic = 0;
+        munmap(m_segment, sizeof(Telemetry::SSegment));
+        shm_unlink(Telemetry::segmentName().c_str());
+    }
+    if (m_fd >= 0)
+        ::close(m_fd);
+
+    m_segment = nullptr;
+    m_fd      = -1;
+}
+
+void CTelemetryPublisher::shutdown() noexcept {
+    close();
+    m_gpuTimer.release();
+}
+
+// ── GPU stages ───────────────────────────────────────────────────────────────
+
+// Tags pack the frame sequence above the stage
+static constexpr int STAGE_TAG_BITS = 8;
+
+GLuint CTelemetryPublisher::beginStage() {
+    return m_gpuTimer.begin();
+}
+
+void CTelemetryPublisher::endStage(Telemetry::eStage stage, GLuint beginQuery) {
+    m_gpuTimer.end(beginQuery, (m_sequence << STAGE_TAG_BITS) | stage);
+}
+
+void CTelemetryPublisher::collectGpuStages() {
+    // Ranges resolve in submission order: once one of a later frame arrives,
+    // the frame being collected is complete
+    m_gpuTimer.collect([this](uint64_t tag, uint64_t, uint64_t durationNs) {
+        const uint64_t sequence = tag >> STAGE_TAG_BITS;
+        const auto     stage    = static_cast<size_t>(tag & ((1u << STAGE_TAG_BITS) - 1));
+
+        if (sequence != m_gpuCollecting.sequence) {
+            if (m_gpuCollecting.sequence)
+                m_gpuComplete = m_gpuCollecting;
+            m_gpuCollecting = {sequence, {}};
+        }
+
+        if (stage < Telemetry::STAGE_LAST)
+            m_gpuCollecting.ms[stage] += static_cast<float>(durationNs / 1e6);
+    });
+}
+
+CTelemetryStageTimer::CTelemetryStageTimer(Telemetry::eStage stage) : m_stage(stage) {
+    auto& telemetry = g_pGlobalState->telemetry;
+    if (telemetry.enabled())
+        m_beginQuery = telemetry.beginStage();
+}
+
+CTelemetryStageTimer::~CTelemetryStageTimer() {
+    if (m_beginQuery)
+        g_pGlobalState->telemetry.endStage(m_stage, m_beginQuery);
+}
+
+// ── Publishing ───────────────────────────────────────────────────────────────
+
+void CTelemetryPublisher::publishFrame() {
+    if (!enabled()) {
+        close();
+        m_openFailed = false;
+        m_frame      = {};
+        return;
+    }
+
+    if (!m_frame.windowsDrawn)
+        return;
+
+    if (!m_segment && !m_openFailed && !open()) {
+        m_openFailed = true;
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::string("[hyprglass] Could not create the telemetry segment ") + Telemetry::segmentName() + "."},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
+        });
+    }
+    if (!m_segment) {
+        m_frame = {};
+        return;
+    }
+
+    collectGpuStages();
+
+    // GL state cache activity since the last published frame (the counters
+    // may have been reset through hyprctl in between)
+    const auto& glState = g_pGlobalState->glState;
+    uint64_t    issued = 0, skipped = 0;
+    for (size_t i = 0; i < CGLStateCache::COUNTER_LAST; i++) {
+        issued += glState.counter(static_cast<CGLStateCache::eCounter>(i)).issued;
+        skipped += glState.counter(static_cast<CGLStateCache::eCounter>(i)).skipped;
+    }
+    if (issued < m_lastIssued || skipped < m_lastSkipped)
+        m_lastIssued = m_lastSkipped = 0;
+
+    m_frame.sequence       = m_sequence;
+    m_frame.timestampNs    = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    m_frame.glCallsIssued  = static_cast<uint32_t>(issued - m_lastIssued);
+    m_frame.glCallsSkipped = static_cast<uint32_t>(skipped - m_lastSkipped);
+    m_frame.gpuSequence    = m_gpuComplete.sequence;
+    m_frame.gpuMs          = m_gpuComplete.ms;
+    m_lastIssued           = issued;
+    m_lastSkipped          = skipped;
+
+    // Seqlock write: odd version, frame, even version, then make it visible
+    auto&          slot    = m_segment->slots[m_sequence % Telemetry::CAPACITY];
+    const uint64_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.frame = m_frame;
+    slot.version.store(version + 2, std::memory_order_release);
+    m_segment->published.store(m_sequence, std::memory_order_release);
+
+    m_sequence++;
+    m_frame = {};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "GpuTimer.hpp"
+#include "TelemetryFormat.hpp"
+
+#include <GLES3/gl32.h>
+#include <array>
+#include <cstdint>
+
+// Per-frame plugin metrics published into the shared-memory ring described
+// in TelemetryFormat.hpp, while plugin:hyprglass:telemetry is set.
+//
+// Counters accumulate during a monitor's render and are written out at the
+// end of it with a few plain stores and two atomic ones: publishing never
+// blocks, allocates or makes a syscall. The segment is created on the first
+// frame after telemetry is enabled and unlinked when it is disabled.
+class CTelemetryPublisher {
+  public:
+    CTelemetryPublisher() = default;
+    ~CTelemetryPublisher();
+
+    CTelemetryPublisher(const CTelemetryPublisher&)            = delete;
+    CTelemetryPublisher& operator=(const CTelemetryPublisher&) = delete;
+
+    [[nodiscard]] bool enabled() const noexcept;
+
+    void countWindowDrawn(int64_t monitorId) noexcept {
+        m_frame.windowsDrawn++;
+        m_frame.monitorId = monitorId;
+    }
+    void countFramebufferRealloc() noexcept { m_frame.framebufferReallocs++; }
+    void countSampleReuse() noexcept { m_frame.sampleReuses++; }
+    void countPixelsBlurred(uint64_t pixels) noexcept { m_frame.pixelsBlurred += pixels; }
+
+    // GPU time of a stage, tagged with the frame it belongs to
+    [[nodiscard]] GLuint beginStage();
+    void                 endStage(Telemetry::eStage stage, GLuint beginQuery);
+
+    // End of a monitor frame: publish what was counted, if anything was drawn
+    void publishFrame();
+
+    // Unmaps and unlinks the segment, frees the queries (context must be current)
+    void shutdown() noexcept;
+
+  private:
+    int                  m_fd      = -1;
+    Telemetry::SSegment* m_segment = nullptr;
+    bool                 m_openFailed = false;
+
+    uint64_t          m_sequence = 1;
+    Telemetry::SFrame m_frame    = {};
+
+    CGpuTimer m_gpuTimer;
+    struct SGpuFrame {
+        uint64_t                                  sequence = 0;
+        std::array<float, Telemetry::STAGE_LAST> ms       = {};
+    };
+    SGpuFrame m_gpuCollecting; // results keep arriving for this frame
+    SGpuFrame m_gpuComplete;   // latest frame with every result in
+
+    uint64_t m_lastIssued  = 0;
+    uint64_t m_lastSkipped = 0;
+
+    bool open();
+    void close() noexcept;
+    void collectGpuStages();
+};
+
+// Times the enclosing scope as a telemetry stage, when telemetry is enabled
+class CTelemetryStageTimer {
+  public:
+    explicit CTelemetryStageTimer(Telemetry::eStage stage);
+    ~CTelemetryStageTimer();
+
+    CTelemetryStageTimer(const CTelemetryStageTimer&)            = delete;
+    CTelemetryStageTimer& operator=(const CTelemetryStageTimer&) = delete;
+
+  private:
+    Telemetry::eStage m_stage;
+    GLuint            m_beginQuery = 0;
+};
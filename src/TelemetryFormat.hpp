@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unistd.h>
+
+// Layout of the shared-memory telemetry ring, shared by the plugin (the only
+// writer) and tools/hyprglass-telemetry. Bump VERSION on any change.
+//
+// The plugin publishes one SFrame per monitor frame it drew glass in. Each
+// slot is a seqlock: its version is odd while the frame is being written, so
+// a reader copies the frame, re-reads the version and retries or skips on a
+// mismatch. The writer never waits on readers; a reader that falls more than
+// CAPACITY frames behind loses the oldest ones.
+namespace Telemetry {
+
+inline constexpr uint32_t MAGIC    = 0x4c475948; // "HYGL"
+inline constexpr uint32_t VERSION  = 1;
+inline constexpr uint32_t CAPACITY = 1024;
+
+enum eStage : uint8_t {
+    STAGE_SAMPLE = 0, // unblurred copy of the backdrop
+    STAGE_BLUR,       // offscreen blur passes
+    STAGE_GLASS,      // glass composite
+    STAGE_LAST,
+};
+
+struct SFrame {
+    uint64_t sequence;    // from 1, stored in slot sequence % CAPACITY
+    uint64_t timestampNs; // CLOCK_MONOTONIC
+    int64_t  monitorId;
+
+    uint32_t windowsDrawn;
+    uint32_t framebufferReallocs;
+    uint64_t pixelsBlurred;  // written by the offscreen blur passes
+    uint32_t sampleReuses;   // windows that only resampled their damage
+    uint32_t glCallsIssued;  // state changes that reached GL
+    uint32_t glCallsSkipped; // redundant state changes filtered out
+
+    // GPU time per stage of an earlier frame: results arrive a few frames
+    // late. gpuSequence is 0 when no GPU time has been measured yet.
+    uint32_t                      reserved;
+    uint64_t                      gpuSequence;
+    std::array<float, STAGE_LAST> gpuMs;
+};
+
+static_assert(std::is_trivially_copyable_v<SFrame>);
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+struct SSlot {
+    std::atomic<uint64_t> version; // odd: being written
+    SFrame                frame;
+};
+
+struct SSegment {
+    uint32_t magic; // written last on creation, cleared when the plugin closes the ring
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t frameSize;
+
+    alignas(64) std::atomic<uint64_t> published; // sequence of the last frame written, 0: none
+
+    alignas(64) std::array<SSlot, CAPACITY> slots;
+};
+
+// Per user, so concurrent sessions of different users do not collide
+inline std::string segmentName() {
+    return "/hyprglass-telemetry-" + std::to_string(getuid());
+}
+
+} // namespace Telemetry
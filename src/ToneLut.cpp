@@ -0,0 +1,76 @@
+#include "ToneLut.hpp"
+#include "Globals.hpp"
+
+CToneLuts::~CToneLuts() {
+    release();
+}
+
+void CToneLuts::release() noexcept {
+    for (const auto& lut : m_luts) {
+        if (lut && lut->texture)
+            glDeleteTextures(1, &lut->texture);
+    }
+
+    m_luts.clear();
+    m_texels.clear();
+    m_texels.shrink_to_fit();
+}
+
+BakeKernels::STone CToneLuts::toneOf(const SPresetValues& params) {
+    const int64_t tint = params.tintColor;
+
+    return {
+        .brightness       = params.brightness,
+        .contrast         = params.contrast,
+        .saturation       = params.saturation,
+        .vibrancy         = params.vibrancy,
+        .vibrancyDarkness = params.vibrancyDarkness,
+        .adaptiveDim      = params.adaptiveDim,
+        .adaptiveBoost    = params.adaptiveBoost,
+        .tintColor        = {static_cast<float>((tint >> 24) & 0xFF) / 255.0f, static_cast<float>((tint >> 16) & 0xFF) / 255.0f,
+                             static_cast<float>((tint >> 8) & 0xFF) / 255.0f},
+        .tintAlpha        = static_cast<float>(tint & 0xFF) / 255.0f,
+    };
+}
+
+GLuint CToneLuts::texture(PresetId presetId, bool isDark, const SPresetValues& params) {
+    const size_t index = static_cast<size_t>(presetId) * 2 + (isDark ? 1 : 0);
+    if (index >= m_luts.size())
+        m_luts.resize(index + 1);
+
+    auto& slot = m_luts[index];
+    if (!slot)
+        slot = std::make_unique<SLut>();
+
+    const auto tone = toneOf(params);
+    if (!slot->texture || slot->tone != tone) {
+        slot->tone = tone;
+        bake(*slot);
+    }
+
+    return slot->texture;
+}
+
+// ── Bake ─────────────────────────────────────────────────────────────────────
+
+void CToneLuts::bake(SLut& lut) {
+    BakeKernels::toneLut(lut.tone, m_texels);
+
+    if (!lut.texture) {
+        glGenTextures(1, &lut.texture);
+        glBindTexture(GL_TEXTURE_3D, lut.texture);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    } else
+        glBindTexture(GL_TEXTURE_3D, lut.texture);
+
+    // Converted to half floats by the driver
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, SIZE, SIZE, SIZE, 0, GL_RGBA, GL_FLOAT, m_texels.data());
+    lut.vram.set(static_cast<size_t>(SIZE) * SIZE * SIZE * 4 * sizeof(uint16_t));
+    g_pGlobalState->glState.countAllocation();
+    glBindTexture(GL_TEXTURE_3D, 0);
+    g_pGlobalState->glState.invalidateTextures();
+}
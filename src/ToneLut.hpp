@@ -0,0 +1,45 @@
+#pragma once
+
+#include "BakeKernels.hpp"
+#include "PluginConfig.hpp"
+#include "VramTracker.hpp"
+
+#include <GLES3/gl32.h>
+#include <memory>
+#include <vector>
+
+// Frosted tint of the glass shaders, baked into a SIZE³ RGBA16F texture per
+// preset and theme: desaturation, adaptive dim and boost, contrast, vibrancy
+// and the tint overlay only depend on the blurred colour and the preset, so
+// the shaders replace them with one trilinear fetch. Output is not clamped:
+// boost and vibrancy may leave [0,1] the same way the shader math did.
+class CToneLuts {
+  public:
+    CToneLuts() = default;
+    ~CToneLuts();
+
+    CToneLuts(const CToneLuts&)            = delete;
+    CToneLuts& operator=(const CToneLuts&) = delete;
+
+    // LUT of the preset's theme variant, baked again if its values changed.
+    // Baking binds behind the state cache and leaves its textures unknown.
+    [[nodiscard]] GLuint texture(PresetId presetId, bool isDark, const SPresetValues& params);
+    void                 release() noexcept;
+
+    static constexpr int SIZE = BakeKernels::TONE_LUT_SIZE;
+
+    // The baked inputs of a preset's theme variant
+    [[nodiscard]] static BakeKernels::STone toneOf(const SPresetValues& params);
+
+  private:
+    struct SLut {
+        GLuint             texture = 0;
+        BakeKernels::STone tone;
+        CVramAllocation    vram{VRAM_TONE_LUT};
+    };
+
+    std::vector<std::unique_ptr<SLut>> m_luts; // indexed by presetId * 2 + isDark
+    std::vector<float>                 m_texels;
+
+    void bake(SLut& lut);
+};
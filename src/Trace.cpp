@@ -0,0 +1,176 @@
+#include "Trace.hpp"
+
+#ifndef HYPRGLASS_TRACE
+
+namespace Trace {
+
+bool compiledIn() noexcept {
+    return false;
+}
+
+SStatus start(std::string_view path) {
+    return {false, "tracing is not compiled in (rebuild with `make TRACE=1`)"};
+}
+
+SStatus stop() {
+    return start({});
+}
+
+} // namespace Trace
+
+#else
+
+#include "GpuTimer.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace Trace {
+
+enum eTrack : uint8_t {
+    TRACK_CPU = 1,
+    TRACK_GPU = 2,
+};
+
+struct SEvent {
+    const char* name;
+    uint64_t    startNs;
+    uint64_t    durationNs;
+    eTrack      track;
+};
+
+// Bounds memory if a trace is left running: ~32 MB of events
+static constexpr size_t MAX_EVENTS = 1u << 20;
+
+// GPU results are collected in batches: collecting queries the disjoint flag
+static constexpr size_t GPU_COLLECT_BATCH = 64;
+
+struct STraceState {
+    bool                active = false;
+    std::string         path;
+    std::vector<SEvent> events;
+    size_t              dropped = 0;
+
+    // GPU zones are tagged with their name
+    CGpuTimer gpuTimer;
+};
+
+static STraceState s_trace;
+
+static uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void record(const char* name, uint64_t startNs, uint64_t durationNs, eTrack track) {
+    if (s_trace.events.size() >= MAX_EVENTS) {
+        s_trace.dropped++;
+        return;
+    }
+
+    s_trace.events.push_back({name, startNs, durationNs, track});
+}
+
+static void collectGpuZones() {
+    s_trace.gpuTimer.collect([](uint64_t tag, uint64_t startNs, uint64_t durationNs) {
+        record(reinterpret_cast<const char*>(static_cast<uintptr_t>(tag)), startNs, durationNs, TRACK_GPU);
+    });
+}
+
+// ── Zones ────────────────────────────────────────────────────────────────────
+
+bool active() noexcept {
+    return s_trace.active;
+}
+
+CCpuZone::CCpuZone(const char* name) : m_name(name) {
+    if (s_trace.active)
+        m_startNs = nowNs();
+}
+
+CCpuZone::~CCpuZone() {
+    if (m_startNs && s_trace.active)
+        record(m_name, m_startNs, nowNs() - m_startNs, TRACK_CPU);
+}
+
+CGpuZone::CGpuZone(const char* name) : m_name(name) {
+    if (!s_trace.active)
+        return;
+
+    if (s_trace.gpuTimer.pendingRanges() >= GPU_COLLECT_BATCH)
+        collectGpuZones();
+    m_beginQuery = s_trace.gpuTimer.begin();
+}
+
+CGpuZone::~CGpuZone() {
+    if (s_trace.active)
+        s_trace.gpuTimer.end(m_beginQuery, reinterpret_cast<uintptr_t>(m_name));
+}
+
+// ── Control ──────────────────────────────────────────────────────────────────
+
+bool compiledIn() noexcept {
+    return true;
+}
+
+SStatus start(std::string_view path) {
+    if (s_trace.active)
+        return {false, std::format("already tracing to {}", s_trace.path)};
+
+    if (path.empty()) {
+        const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR");
+        const auto  seconds    = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        s_trace.path = std::format("{}/hyprglass-trace-{}.json", runtimeDir ? runtimeDir : "/tmp", seconds);
+    } else
+        s_trace.path = path;
+
+    s_trace.events.clear();
+    s_trace.events.reserve(1u << 16);
+    s_trace.dropped = 0;
+    s_trace.active  = true;
+
+    return {true, std::format("tracing to {}", s_trace.path)};
+}
+
+SStatus stop() {
+    if (!s_trace.active)
+        return {false, "not tracing"};
+
+    collectGpuZones();
+    s_trace.gpuTimer.release();
+    s_trace.active = false;
+
+    std::ofstream file(s_trace.path);
+    if (!file)
+        return {false, std::format("failed to open {}", s_trace.path)};
+
+    file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 1, \"args\": {\"name\": \"hyprglass CPU\"}},\n";
+    file << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 2, \"args\": {\"name\": \"hyprglass GPU\"}}";
+
+    for (const auto& event : s_trace.events) {
+        file << std::format(",\n{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 1, \"tid\": {}, \"ts\": {:.3f}, \"dur\": {:.3f}}}",
+                            event.name, static_cast<int>(event.track), event.startNs / 1000.0, event.durationNs / 1000.0);
+    }
+    file << "\n]}\n";
+    file.close();
+
+    const auto written = s_trace.events.size();
+    s_trace.events     = {};
+
+    if (!file)
+        return {false, std::format("failed to write {} events to {}", written, s_trace.path)};
+
+    std::string result = std::format("wrote {} events to {}", written, s_trace.path);
+    if (s_trace.dropped)
+        result += std::format(" ({} dropped over the event limit)", s_trace.dropped);
+    if (!s_trace.gpuTimer.supported())
+        result += " (no GPU zones: EXT_disjoint_timer_query unavailable)";
+    return {true, result};
+}
+
+} // namespace Trace
+
+#endif
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Optional timeline tracing of the plugin's hot paths, written as a Chrome
+// trace (JSON) loadable in Perfetto or chrome://tracing.
+//
+// Compiled in only with HYPRGLASS_TRACE (`make TRACE=1`); otherwise the zone
+// macros expand to nothing. CPU zones time the enclosing scope; GPU zones
+// bracket it with EXT_disjoint_timer_query timestamps, resolved a few frames
+// later without waiting, and are drawn on their own track.
+namespace Trace {
+
+[[nodiscard]] bool compiledIn() noexcept;
+
+// Outcome of a hyprctl command: whether it took effect, and a status line
+struct SStatus {
+    bool        ok = false;
+    std::string text;
+};
+
+// hyprctl entry points
+[[nodiscard]] SStatus start(std::string_view path);
+[[nodiscard]] SStatus stop();
+
+} // namespace Trace
+
+#ifdef HYPRGLASS_TRACE
+
+#include <cstdint>
+
+namespace Trace {
+
+[[nodiscard]] bool active() noexcept;
+
+class CCpuZone {
+  public:
+    explicit CCpuZone(const char* name);
+    ~CCpuZone();
+
+    CCpuZone(const CCpuZone&)            = delete;
+    CCpuZone& operator=(const CCpuZone&) = delete;
+
+  private:
+    const char* m_name;
+    uint64_t    m_startNs = 0;
+};
+
+class CGpuZone {
+  public:
+    explicit CGpuZone(const char* name);
+    ~CGpuZone();
+
+    CGpuZone(const CGpuZone&)            = delete;
+    CGpuZone& operator=(const CGpuZone&) = delete;
+
+  private:
+    const char* m_name;
+    uint32_t    m_beginQuery = 0;
+};
+
+} // namespace Trace
+
+#define HYPRGLASS_TRACE_CONCAT_INNER(a, b) a##b
+#define HYPRGLASS_TRACE_CONCAT(a, b)       HYPRGLASS_TRACE_CONCAT_INNER(a, b)
+#define TRACE_CPU_ZONE(name)               const Trace::CCpuZone HYPRGLASS_TRACE_CONCAT(traceCpuZone, __LINE__){name}
+#define TRACE_GPU_ZONE(name)               const Trace::CGpuZone HYPRGLASS_TRACE_CONCAT(traceGpuZone, __LINE__){name}
+
+#else
+
+#define TRACE_CPU_ZONE(name) ((void)0)
+#define TRACE_GPU_ZONE(name) ((void)0)
+
+#endif
@@ -0,0 +1,122 @@
+#include "VramTracker.hpp"
+#include "GlassDecoration.hpp"
+#include "Globals.hpp"
+
+#include <hyprland/src/helpers/Format.hpp>
+
+#include <algorithm>
+#include <vector>
+
+// ── Accounting ───────────────────────────────────────────────────────────────
+
+void CVramTracker::account(eVramCategory which, size_t previousBytes, size_t bytes) {
+    auto& category = m_categories[which];
+    category.bytes += bytes;
+    category.bytes -= std::min(previousBytes, category.bytes);
+
+    if (!previousBytes && bytes)
+        category.allocations++;
+    else if (previousBytes && !bytes && category.allocations)
+        category.allocations--;
+}
+
+size_t CVramTracker::totalBytes() const noexcept {
+    size_t total = 0;
+    for (const auto& category : m_categories)
+        total += category.bytes;
+    return total;
+}
+
+size_t CVramTracker::budgetBytes() const noexcept {
+    const auto& budgetMb = g_pGlobalState->config.vramBudgetMb;
+    if (!budgetMb || **budgetMb <= 0)
+        return 0;
+
+    return static_cast<size_t>(**budgetMb) * 1024 * 1024;
+}
+
+CVramAllocation::~CVramAllocation() {
+    set(0);
+}
+
+void CVramAllocation::set(size_t bytes) {
+    if (bytes == m_bytes)
+        return;
+
+    if (g_pGlobalState)
+        g_pGlobalState->vram.account(m_category, m_bytes, bytes);
+
+    m_bytes = bytes;
+}
+
+size_t framebufferBytes(CFramebuffer& framebuffer) {
+    if (!framebuffer.isAllocated())
+        return 0;
+
+    const auto* format        = NFormatUtils::getPixelFormatFromDRM(framebuffer.m_drmFormat);
+    const auto  bytesPerPixel = format && format->bytesPerBlock ? format->bytesPerBlock : 4;
+
+    return static_cast<size_t>(framebuffer.m_size.x) * static_cast<size_t>(framebuffer.m_size.y) * bytesPerPixel;
+}
+
+// ── Budget ───────────────────────────────────────────────────────────────────
+
+void CVramTracker::enforceBudget(const CGlassDecoration* current) {
+    const size_t budget = budgetBytes();
+    size_t       total  = totalBytes();
+    if (!budget || total <= budget)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    // The working set is culled on the registry's own state, before any decoration is touched
+    const auto entries = g_pGlobalState->decorations.entries();
+    m_candidates.clear();
+    for (uint32_t i = 0; i < entries.size(); i++) {
+        if (now - entries[i].lastRenderedAt < EVICTION_GRACE)
+            continue;
+
+        m_candidates.push_back(i);
+    }
+
+    std::ranges::sort(m_candidates, {}, [&entries](uint32_t i) { return entries[i].lastRenderedAt; });
+
+    for (const uint32_t candidate : m_candidates) {
+        if (total <= budget)
+            break;
+
+        const auto decoration = entries[candidate].decoration.lock();
+        if (!decoration || decoration.get() == current || !decoration->evictableBytes())
+            continue;
+
+        total -= std::min(decoration->evictableBytes(), total);
+        decoration->evictBuffers();
+        m_evictions++;
+    }
+}
+
+// ── Idle release ─────────────────────────────────────────────────────────────
+
+void CVramTracker::releaseIdle(const CGlassDecoration* current) {
+    const auto& idleSeconds = g_pGlobalState->config.idleReleaseSeconds;
+    if (!idleSeconds || **idleSeconds <= 0)
+        return;
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastIdleSweep < IDLE_SWEEP_INTERVAL)
+        return;
+    m_lastIdleSweep = now;
+
+    const auto idleAfter = std::chrono::seconds(**idleSeconds);
+    for (const auto& entry : g_pGlobalState->decorations.entries()) {
+        if (now - entry.lastRenderedAt < idleAfter)
+            continue;
+
+        const auto decoration = entry.decoration.lock();
+        if (!decoration || decoration.get() == current || !decoration->evictableBytes())
+            continue;
+
+        decoration->evictBuffers();
+        m_idleReleases++;
+    }
+}
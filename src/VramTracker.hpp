@@ -0,0 +1,88 @@
+#pragma once
+
+#include <hyprland/src/render/Framebuffer.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CGlassDecoration;
+
+enum eVramCategory : uint8_t {
+    VRAM_SAMPLE = 0,     // per-decoration padded backdrop sample
+    VRAM_BLUR_TEMP,      // shared blur ping-pong buffer
+    VRAM_EDGE_FIELD,     // per-decoration baked SDF tile
+    VRAM_BACKDROP_PROBE, // per-decoration luminance reduction (automatic theme)
+    VRAM_BACKDROP_CACHE, // per-monitor layer copy and its blurs
+    VRAM_TONE_LUT,       // frosted tint per preset and theme
+    VRAM_LAST,
+};
+
+// Byte totals of every GPU resource the plugin owns, and the policies that
+// free them: plugin:hyprglass:vram_budget_mb and idle_release_seconds.
+//
+// Owners report through a CVramAllocation member, so a resource is accounted
+// for exactly as long as it exists. Evicted decorations reallocate their
+// buffers and fully resample the next time the window is drawn.
+class CVramTracker {
+  public:
+    struct SCategory {
+        size_t bytes       = 0;
+        size_t allocations = 0;
+    };
+
+    [[nodiscard]] const SCategory& category(eVramCategory which) const { return m_categories[which]; }
+    [[nodiscard]] size_t           totalBytes() const noexcept;
+    [[nodiscard]] size_t           budgetBytes() const noexcept; // 0: unlimited
+    [[nodiscard]] uint64_t         evictions() const noexcept { return m_evictions; }
+    [[nodiscard]] uint64_t         idleReleases() const noexcept { return m_idleReleases; }
+
+    // Evict decorations other than current, oldest first, until under budget.
+    // Decorations drawn within EVICTION_GRACE are the working set and kept.
+    void enforceBudget(const CGlassDecoration* current);
+
+    // Evict decorations that have not been drawn for idle_release_seconds:
+    // windows on other workspaces, hidden special workspaces, minimized
+    // scratchpads. Runs from render passes, at most every IDLE_SWEEP_INTERVAL.
+    void releaseIdle(const CGlassDecoration* current);
+
+    static constexpr auto EVICTION_GRACE      = std::chrono::seconds(1);
+    static constexpr auto IDLE_SWEEP_INTERVAL = std::chrono::seconds(1);
+
+  private:
+    std::array<SCategory, VRAM_LAST> m_categories;
+    uint64_t                         m_evictions    = 0;
+    uint64_t                         m_idleReleases = 0;
+
+    std::chrono::steady_clock::time_point m_lastIdleSweep;
+
+    // enforceBudget() scratch, kept for its storage: registry entry indices
+    std::vector<uint32_t> m_candidates;
+
+    void account(eVramCategory which, size_t previousBytes, size_t bytes);
+
+    friend class CVramAllocation;
+};
+
+// One accounted resource. Tolerates the global state being gone already, as
+// happens for resources destroyed during plugin teardown.
+class CVramAllocation {
+  public:
+    explicit CVramAllocation(eVramCategory category) : m_category(category) {}
+    ~CVramAllocation();
+
+    CVramAllocation(const CVramAllocation&)            = delete;
+    CVramAllocation& operator=(const CVramAllocation&) = delete;
+
+    void                 set(size_t bytes);
+    [[nodiscard]] size_t bytes() const noexcept { return m_bytes; }
+
+  private:
+    eVramCategory m_category;
+    size_t        m_bytes = 0;
+};
+
+// Size of the color attachment of an allocated framebuffer
+[[nodiscard]] size_t framebufferBytes(CFramebuffer& framebuffer);
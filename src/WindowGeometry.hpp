@@ -24,4 +24,14 @@ namespace WindowGeometry {
     return box;
 }
 
+// Stacking order as Hyprland renders it: tiled, then floating in list order,
+// then pinned, then fullscreen on top
+[[nodiscard]] inline int stackingLayer(const PHLWINDOW& window) {
+    if (window->isFullscreen())
+        return 3;
+    if (window->m_pinned)
+        return 2;
+    return window->m_isFloating ? 1 : 0;
+}
+
 } // namespace WindowGeometry
@@ -1,5 +1,8 @@
 #include "GlassDecoration.hpp"
+#include "GlassPassElement.hpp"
 #include "Globals.hpp"
+#include "HyprCtl.hpp"
+#include "LevelOfDetail.hpp"
 #include "PluginConfig.hpp"
 
 #include <hyprland/src/Compositor.hpp>
@@ -10,21 +13,75 @@
 #include <hyprland/src/event/EventBus.hpp>
 
 static void onNewWindow(PHLWINDOW window) {
-    if (std::ranges::any_of(window->m_windowDecorations,
-                            [](const auto& decoration) { return decoration->getDisplayName() == "HyprGlass"; }))
+    // A reopened window keeps its decoration, but the close dropped its entry
+    for (const auto& existing : window->m_windowDecorations) {
+        if (existing->getDisplayName() != "HyprGlass")
+            continue;
+
+        auto* decoration = static_cast<CGlassDecoration*>(existing.get());
+        if (!g_pGlobalState->decorations.contains(window))
+            decoration->m_handle = g_pGlobalState->decorations.add(window, decoration->m_self);
         return;
+    }
 
     auto decoration = makeUnique<CGlassDecoration>(window);
-    g_pGlobalState->decorations.emplace_back(decoration);
-    decoration->m_self = decoration;
+    decoration->m_self   = decoration;
+    decoration->m_handle = g_pGlobalState->decorations.add(window, decoration);
     HyprlandAPI::addWindowDecoration(PHANDLE, window, std::move(decoration));
 }
 
 static void onCloseWindow(PHLWINDOW window) {
-    std::erase_if(g_pGlobalState->decorations, [&window](const auto& decoration) {
-        auto locked = decoration.lock();
-        return !locked || locked->getOwner() == window;
-    });
+    g_pGlobalState->decorations.remove(window);
+}
+
+// Hyprland marks a monitor's blur dirty whenever its background or bottom
+// layers change: the backdrop cache follows the same signal
+static CFunctionHook* g_pMarkBlurDirtyHook = nullptr;
+using FMarkBlurDirtyForMonitor = void (*)(CHyprOpenGLImpl*, PHLMONITOR);
+
+static void hkMarkBlurDirtyForMonitor(CHyprOpenGLImpl* thisptr, PHLMONITOR monitor) {
+    reinterpret_cast<FMarkBlurDirtyForMonitor>(g_pMarkBlurDirtyHook->m_original)(thisptr, monitor);
+
+    if (g_pGlobalState)
+        g_pGlobalState->backdropCache.invalidate(monitor);
+}
+
+static bool hookMarkBlurDirty() {
+    for (const auto& match : HyprlandAPI::findFunctionsByName(PHANDLE, "markBlurDirtyForMonitor")) {
+        if (!match.demangled.contains("CHyprOpenGLImpl::markBlurDirtyForMonitor"))
+            continue;
+
+        g_pMarkBlurDirtyHook = HyprlandAPI::createFunctionHook(PHANDLE, match.address, reinterpret_cast<void*>(&hkMarkBlurDirtyForMonitor));
+        return g_pMarkBlurDirtyHook && g_pMarkBlurDirtyHook->hook();
+    }
+
+    return false;
+}
+
+// `hyprctl keyword` changes a config layer without a reload: flatten the
+// presets again after each of our keywords, rather than checking every draw
+static CFunctionHook* g_pParseKeywordHook = nullptr;
+using FParseKeyword = std::string (*)(CConfigManager*, const std::string&, const std::string&);
+
+static std::string hkParseKeyword(CConfigManager* thisptr, const std::string& command, const std::string& value) {
+    auto result = reinterpret_cast<FParseKeyword>(g_pParseKeywordHook->m_original)(thisptr, command, value);
+
+    // Committed presets are untouched, so are the inheritance errors validateConfig() reported
+    if (g_pGlobalState && command.starts_with(CONFIG_PREFIX))
+        flattenPresets();
+    return result;
+}
+
+static bool hookParseKeyword() {
+    for (const auto& match : HyprlandAPI::findFunctionsByName(PHANDLE, "parseKeyword")) {
+        if (!match.demangled.contains("CConfigManager::parseKeyword"))
+            continue;
+
+        g_pParseKeywordHook = HyprlandAPI::createFunctionHook(PHANDLE, match.address, reinterpret_cast<void*>(&hkParseKeyword));
+        return g_pParseKeywordHook && g_pParseKeywordHook->hook();
+    }
+
+    return false;
 }
 
 APICALL EXPORT std::string PLUGIN_API_VERSION() {
@@ -55,8 +112,44 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
 
     static auto onConfigReloaded = Event::bus()->m_events.config.reloaded.listen([&]() { commitPendingPresets(); validateConfig(); });
 
+    static auto onRenderStage = Event::bus()->m_events.render.stage.listen([&](eRenderStage stage) {
+        if (stage == RENDER_PRE_WINDOWS) {
+            const auto monitor = g_pHyprOpenGL->m_renderData.pMonitor.lock();
+            if (monitor) {
+                LevelOfDetail::updateVisibility(g_pGlobalState->decorations);
+                g_pGlobalState->backdropCache.onPreWindows(monitor);
+            }
+        } else if (stage == RENDER_POST) {
+            g_pGlobalState->telemetry.publishFrame();
+
+            const auto monitor = g_pHyprOpenGL->m_renderData.pMonitor.lock();
+            g_pGlobalState->capture.endFrame(monitor ? monitor->m_id : -1);
+        }
+    });
+
+    const bool blurDirtyHooked = hookMarkBlurDirty();
+    if (!blurDirtyHooked) {
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::string("[hyprglass] Could not hook markBlurDirtyForMonitor. The backdrop cache is disabled.")},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
+        });
+    }
+    g_pGlobalState->backdropCache.setInvalidationHooked(blurDirtyHooked);
+
+    if (!hookParseKeyword()) {
+        HyprlandAPI::addNotificationV2(PHANDLE, {
+            {"text", std::string("[hyprglass] Could not hook parseKeyword. hyprctl keyword changes apply on the next config reload.")},
+            {"time", (uint64_t)5000},
+            {"color", CHyprColor{1.0, 0.8, 0.2, 1.0}},
+        });
+    }
+
     registerConfig(PHANDLE);
     initConfigPointers(PHANDLE, g_pGlobalState->config);
+    // Draws before the first reload resolve against the built-in chain
+    flattenPresets();
+    registerHyprCtlCommands(PHANDLE);
 
     // Shadows must be enabled for the glass effect to sample the correct background.
     // Force-enable if the user has disabled them.
@@ -78,17 +171,31 @@ APICALL EXPORT PLUGIN_DESCRIPTION_INFO PLUGIN_INIT(HANDLE handle) {
 }
 
 APICALL EXPORT void PLUGIN_EXIT() {
-    for (auto& decoration : g_pGlobalState->decorations) {
-        auto locked = decoration.lock();
+    // Free GPU resources now rather than whenever the decorations are destroyed
+    for (const auto& entry : g_pGlobalState->decorations.entries()) {
+        auto locked = entry.decoration.lock();
         if (locked) {
+            locked->evictBuffers();
+
             auto owner = locked->getOwner();
             if (owner)
                 owner->removeWindowDeco(locked.get());
         }
     }
+    g_pGlobalState->decorations.clear();
 
     g_pHyprRenderer->m_renderPass.removeAllOfType("CGlassPassElement");
-
+    CGlassPassElement::releasePool();
+    g_pHyprRenderer->m_renderPass.removeAllOfType("CBackdropSnapshotElement");
+    unregisterHyprCtlCommands(PHANDLE);
+
+    g_pGlobalState->blurTempFramebuffer.release();
+    g_pGlobalState->telemetry.shutdown();
+    g_pGlobalState->capture.release();
+    g_pGlobalState->blurTempVram.set(0);
+    g_pGlobalState->backdropCache.release();
+    g_pGlobalState->toneLuts.release();
+    g_pGlobalState->refreshScheduler.release();
     g_pGlobalState->shaderManager.destroy();
     g_pGlobalState.reset();
 }
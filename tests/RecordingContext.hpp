@@ -0,0 +1,254 @@
+#pragma once
+
+#include "../src/GlassPasses.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// GlassPasses context that records instead of drawing. Built with
+// HYPRGLASS_GL_RECORD and without libGLESv2: the pass code can only reach GL
+// through the context, so any call that bypasses it (glGet*, glFinish,
+// readbacks) fails the link rather than going unnoticed.
+//
+// Fences only signal when the test says the GPU got there (signalFences()).
+// Through the context, a call stalls if it maps a pixel pack buffer whose
+// readback may still be in flight, or reads pixels into client memory
+// (buffer 0): both are counted as stall-prone.
+
+struct SRect {
+    int x1, y1, x2, y2;
+};
+
+// Rects of a region, disjoint
+using Region = std::vector<SRect>;
+
+struct SProgram {
+    int id = 0;
+};
+
+struct SDraw {
+    GLuint framebuffer;
+    int    program;
+    SRect  rect;
+};
+
+struct SBlit {
+    GLuint readFramebuffer;
+    GLuint drawFramebuffer;
+    SRect  rect;   // written
+    SRect  source; // read from, before the scissor
+    GLenum filter;
+};
+
+struct SCounts {
+    uint64_t programs         = 0;
+    uint64_t framebufferBinds = 0;
+    uint64_t textureBinds     = 0;
+    uint64_t textureSwitches  = 0; // binds that changed what the unit held
+    uint64_t viewports        = 0;
+    uint64_t uniforms         = 0;
+    uint64_t draws            = 0;
+    uint64_t pixels           = 0;
+    uint64_t blits            = 0;
+    uint64_t blitPixels       = 0;
+    uint64_t mipmaps          = 0;
+    uint64_t readbacks        = 0;
+    uint64_t fences           = 0;
+    uint64_t maps             = 0;
+    uint64_t stallProne       = 0;
+
+    SCounts operator-(const SCounts& other) const {
+        SCounts diff;
+        diff.programs         = programs - other.programs;
+        diff.framebufferBinds = framebufferBinds - other.framebufferBinds;
+        diff.textureBinds     = textureBinds - other.textureBinds;
+        diff.textureSwitches  = textureSwitches - other.textureSwitches;
+        diff.viewports        = viewports - other.viewports;
+        diff.uniforms         = uniforms - other.uniforms;
+        diff.draws            = draws - other.draws;
+        diff.pixels           = pixels - other.pixels;
+        diff.blits            = blits - other.blits;
+        diff.blitPixels       = blitPixels - other.blitPixels;
+        diff.mipmaps          = mipmaps - other.mipmaps;
+        diff.readbacks        = readbacks - other.readbacks;
+        diff.fences           = fences - other.fences;
+        diff.maps             = maps - other.maps;
+        diff.stallProne       = stallProne - other.stallProne;
+        return diff;
+    }
+};
+
+class CRecordingContext {
+  public:
+    SCounts            counts;
+    std::vector<SDraw> draws; // since the last clear
+    std::vector<SBlit> blits; // since the last clear
+
+    CRecordingContext() {
+        // Recording must not allocate on its own while a test counts allocations
+        draws.reserve(1 << 16);
+        blits.reserve(1 << 16);
+        m_fences.reserve(1 << 10);
+    }
+
+    // The GPU catches up: every readback queued so far has landed
+    void signalFences() {
+        for (auto& fence : m_fences)
+            fence.signaled = true;
+    }
+
+    void useProgram(const SProgram& program, const std::array<float, 9>&) {
+        m_program = program.id;
+        counts.programs++;
+    }
+
+    void bindFramebuffer(GLenum target, GLuint framebuffer) {
+        if (target != GL_READ_FRAMEBUFFER)
+            m_framebuffer = framebuffer;
+        if (target != GL_DRAW_FRAMEBUFFER)
+            m_readFramebuffer = framebuffer;
+        counts.framebufferBinds++;
+    }
+
+    void bindTexture(GLuint unit, GLuint texture, GLenum) {
+        counts.textureBinds++;
+        if (m_textures.at(unit) != texture)
+            counts.textureSwitches++;
+        m_textures.at(unit) = texture;
+    }
+
+    void setViewport(GLint, GLint, GLsizei, GLsizei) {
+        counts.viewports++;
+    }
+
+    void uniform1i(GLint location, GLint) {
+        uniform(location);
+    }
+
+    void uniform1f(GLint location, GLfloat) {
+        uniform(location);
+    }
+
+    void uniform2f(GLint location, GLfloat, GLfloat) {
+        uniform(location);
+    }
+
+    void uniform4f(GLint location, GLfloat, GLfloat, GLfloat, GLfloat) {
+        uniform(location);
+    }
+
+    uint64_t drawGrown(const Region& region, double grow, int width, int height) {
+        const int by     = static_cast<int>(grow);
+        uint64_t  pixels = 0;
+        for (const auto& rect : region)
+            pixels += draw({std::max(rect.x1 - by, 0), std::max(rect.y1 - by, 0), std::min(rect.x2 + by, width), std::min(rect.y2 + by, height)});
+        return pixels;
+    }
+
+    uint64_t drawClipped(const Region& region, double x, double y, double width, double height) {
+        const int x1 = static_cast<int>(std::floor(x)), y1 = static_cast<int>(std::floor(y));
+        const int x2 = static_cast<int>(std::ceil(x + width)), y2 = static_cast<int>(std::ceil(y + height));
+
+        uint64_t pixels = 0;
+        for (const auto& rect : region)
+            pixels += draw({std::max(x1, rect.x1), std::max(y1, rect.y1), std::min(x2, rect.x2), std::min(y2, rect.y2)});
+        return pixels;
+    }
+
+    uint64_t blit(const Region& region, const std::array<int, 4>& source, const std::array<int, 4>& target, GLenum filter) {
+        uint64_t pixels = 0;
+        for (const auto& rect : region) {
+            const SRect written = {std::max(rect.x1, target[0]), std::max(rect.y1, target[1]), std::min(rect.x2, target[2]),
+                                   std::min(rect.y2, target[3])};
+            if (written.x2 <= written.x1 || written.y2 <= written.y1)
+                continue;
+
+            // Counted like the plugin does: the scissored rect
+            const uint64_t rectPixels = static_cast<uint64_t>(rect.x2 - rect.x1) * static_cast<uint64_t>(rect.y2 - rect.y1);
+            counts.blits++;
+            counts.blitPixels += rectPixels;
+            pixels += rectPixels;
+            blits.push_back({m_readFramebuffer, m_framebuffer, written, {source[0], source[1], source[2], source[3]}, filter});
+        }
+        return pixels;
+    }
+
+    void generateMipmap(GLenum) {
+        counts.mipmaps++;
+    }
+
+    void readPixels(GLuint buffer, GLint, GLint, GLsizei, GLsizei) {
+        counts.readbacks++;
+        if (!buffer)
+            counts.stallProne++;
+        m_readBuffer = buffer;
+    }
+
+    GLsync fenceSync() {
+        counts.fences++;
+        m_fences.push_back({m_readBuffer, false, false});
+        return reinterpret_cast<GLsync>(static_cast<uintptr_t>(m_fences.size()));
+    }
+
+    bool fenceSignaled(GLsync fence) {
+        return this->fence(fence).signaled;
+    }
+
+    void deleteSync(GLsync fence) {
+        this->fence(fence).deleted = true;
+    }
+
+    const void* mapBuffer(GLuint buffer, size_t bytes) {
+        counts.maps++;
+        // Waits for every readback into the buffer still in flight
+        if (std::ranges::any_of(m_fences, [&](const SFence& fence) { return fence.buffer == buffer && !fence.signaled; }))
+            counts.stallProne++;
+        return bytes <= sizeof(m_texels) ? m_texels.data() : nullptr;
+    }
+
+    void unmapBuffer() {}
+
+    // Fences not deleted yet
+    [[nodiscard]] size_t liveFences() const {
+        return std::ranges::count_if(m_fences, [](const SFence& fence) { return !fence.deleted; });
+    }
+
+  private:
+    struct SFence {
+        GLuint buffer;
+        bool   signaled;
+        bool   deleted;
+    };
+
+    int                      m_program         = 0;
+    GLuint                   m_framebuffer     = 0;
+    GLuint                   m_readFramebuffer = 0;
+    std::array<GLuint, 3>    m_textures        = {};
+    GLuint                   m_readBuffer      = 0;
+    std::vector<SFence>      m_fences;
+    std::array<float, 1024>  m_texels = {};
+
+    SFence& fence(GLsync fence) {
+        return m_fences.at(reinterpret_cast<uintptr_t>(fence) - 1);
+    }
+
+    void uniform(GLint location) {
+        // -1: not in this program, a no-op upload
+        if (location >= 0)
+            counts.uniforms++;
+    }
+
+    uint64_t draw(const SRect& rect) {
+        if (rect.x2 <= rect.x1 || rect.y2 <= rect.y1)
+            return 0;
+
+        const uint64_t pixels = static_cast<uint64_t>(rect.x2 - rect.x1) * static_cast<uint64_t>(rect.y2 - rect.y1);
+        counts.draws++;
+        counts.pixels += pixels;
+        draws.push_back({m_framebuffer, m_program, rect});
+        return pixels;
+    }
+};
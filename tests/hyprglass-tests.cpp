@@ -0,0 +1,580 @@
+// Budget tests for the GL side of the passes: GlassPasses driven through a
+// recording context over scripted layouts, and their allocations counted. Built by `make test` with HYPRGLASS_GL_RECORD, without
+// Hyprland or libGLESv2. The sample copies and the backdrop probe's readback
+// go through the same context, so a stall-prone call there is counted too.
+
+#include "RecordingContext.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+// ── Harness ──────────────────────────────────────────────────────────────────
+
+static int g_failures = 0;
+
+#define EXPECT(condition)                                                                                                                            \
+    do {                                                                                                                                             \
+        if (!(condition)) {                                                                                                                          \
+            std::fprintf(stderr, "  %s:%d: expected %s\n", __FILE__, __LINE__, #condition);                                                          \
+            g_failures++;                                                                                                                            \
+        }                                                                                                                                            \
+    } while (false)
+
+#define EXPECT_EQ(actual, expected)                                                                                                                  \
+    do {                                                                                                                                             \
+        const auto actualValue   = (actual);                                                                                                         \
+        const auto expectedValue = (expected);                                                                                                       \
+        if (static_cast<long long>(actualValue) != static_cast<long long>(expectedValue)) {                                                          \
+            std::fprintf(stderr, "  %s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, static_cast<long long>(actualValue),           \
+                         static_cast<long long>(expectedValue));                                                                                     \
+            g_failures++;                                                                                                                            \
+        }                                                                                                                                            \
+    } while (false)
+
+// Every operator new of the test binary; malloc is not seen
+static uint64_t g_allocations = 0;
+
+void* operator new(std::size_t size) {
+    g_allocations++;
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// ── Geometry ─────────────────────────────────────────────────────────────────
+
+static SRect intersect(const SRect& a, const SRect& b) {
+    return {std::max(a.x1, b.x1), std::max(a.y1, b.y1), std::min(a.x2, b.x2), std::min(a.y2, b.y2)};
+}
+
+static bool empty(const SRect& rect) {
+    return rect.x2 <= rect.x1 || rect.y2 <= rect.y1;
+}
+
+static uint64_t area(const SRect& rect) {
+    return empty(rect) ? 0 : static_cast<uint64_t>(rect.x2 - rect.x1) * static_cast<uint64_t>(rect.y2 - rect.y1);
+}
+
+static bool operator==(const SRect& a, const SRect& b) {
+    return a.x1 == b.x1 && a.y1 == b.y1 && a.x2 == b.x2 && a.y2 == b.y2;
+}
+
+// ── Fixtures ─────────────────────────────────────────────────────────────────
+
+static constexpr SProgram BLUR       = {1};
+static constexpr SProgram STOCHASTIC = {2};
+static constexpr SProgram GLASS      = {3};
+static constexpr SProgram INTERIOR   = {4};
+static constexpr SProgram STATS      = {5};
+
+static constexpr GLuint   MONITOR_FRAMEBUFFER = 10;
+
+static const GlassPasses::SBlurUniforms           BLUR_UNIFORMS       = {0, 1, 2, 3, 4};
+static const GlassPasses::SStochasticBlurUniforms STOCHASTIC_UNIFORMS = {0, 1, 2, 3, 4, 5, 6, 7};
+static const GlassPasses::SBackdropStatsUniforms  STATS_UNIFORMS      = {0, 1, 2, 3};
+
+// Every uniform of glass.frag is live
+static const GlassPasses::SGlassUniforms GLASS_UNIFORMS = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12};
+
+// glass_interior.frag lacks the edge-only ones
+static const GlassPasses::SGlassUniforms INTERIOR_UNIFORMS = {
+    .fullSize      = 0,
+    .glassOpacity  = 5,
+    .uvPadding     = 8,
+    .toneLut       = 10,
+    .blurRadius    = 11,
+    .blurDirection = 12,
+};
+
+static constexpr uint64_t GLASS_UPLOADS    = 13;
+static constexpr uint64_t INTERIOR_UPLOADS = 6;
+
+// render(): the source mapping and radius, the sample mapping when passes
+// follow, a direction per pass
+static constexpr uint64_t blurUploads(int iterations) {
+    return 5 + (iterations > 1 ? 4 : 0) + 2 * (iterations - 1);
+}
+
+static GlassPasses::SBuffer buffer(GLuint framebuffer, int width, int height) {
+    return {framebuffer, framebuffer + 100, width, height};
+}
+
+static GlassPasses::SComposite compositeOver(const SRect& box, double inset) {
+    GlassPasses::SComposite composite;
+    composite.framebuffer    = MONITOR_FRAMEBUFFER;
+    composite.viewportWidth  = 1920;
+    composite.viewportHeight = 1080;
+    composite.box            = {static_cast<double>(box.x1), static_cast<double>(box.y1), static_cast<double>(box.x2 - box.x1),
+                                static_cast<double>(box.y2 - box.y1)};
+    composite.fullSize       = {static_cast<float>(box.x2 - box.x1), static_cast<float>(box.y2 - box.y1)};
+    composite.interiorInset  = inset;
+    composite.sample         = 1;
+    composite.edgeField      = 2;
+    composite.toneLut        = 3;
+    return composite;
+}
+
+// ── Blur passes ──────────────────────────────────────────────────────────────
+
+static void testBlurPassesCoverGrownDamage() {
+    const auto   source    = buffer(1, 1920, 1080);
+    const auto   target    = buffer(2, 960, 540);
+    const auto   temp      = buffer(3, 960, 540);
+    const Region damage    = {{100, 100, 300, 200}};
+    const float  radius    = 10.0f;
+    const int    footprint = static_cast<int>(GlassPasses::footprintPx(radius));
+
+    for (int iterations = 1; iterations <= 5; iterations++) {
+        CRecordingContext gl;
+        const int         passes = 2 * iterations - 1;
+        const uint64_t    pixels = GlassPasses::render(gl, BLUR, BLUR_UNIFORMS, source, {0.0, 0.0}, {1920.0, 1080.0}, target, temp, damage, radius, 0.5f,
+                                                       iterations);
+
+        EXPECT_EQ(gl.counts.draws, passes);
+        EXPECT_EQ(gl.counts.framebufferBinds, passes);
+        EXPECT_EQ(gl.counts.textureBinds, passes);
+        EXPECT_EQ(gl.counts.programs, 1);
+        EXPECT_EQ(gl.counts.viewports, 1);
+        EXPECT_EQ(gl.counts.uniforms, blurUploads(iterations));
+        EXPECT_EQ(gl.counts.pixels, pixels);
+
+        for (int pass = 0; pass < passes && pass < static_cast<int>(gl.draws.size()); pass++) {
+            const int   by       = footprint * (passes - pass);
+            const SRect expected = intersect({100 - by, 100 - by, 300 + by, 200 + by}, {0, 0, 960, 540});
+            EXPECT(gl.draws[pass].rect == expected);
+
+            // Horizontal passes land in target, vertical ones in temp
+            EXPECT_EQ(gl.draws[pass].framebuffer, pass % 2 == 0 ? target.framebuffer : temp.framebuffer);
+        }
+    }
+}
+
+static void testBlurPassesStayInTarget() {
+    const auto   source = buffer(1, 1920, 1080);
+    const auto   target = buffer(2, 960, 540);
+    const auto   temp   = buffer(3, 960, 540);
+    const Region damage = {{0, 0, 40, 40}, {900, 500, 960, 540}};
+
+    CRecordingContext gl;
+    GlassPasses::render(gl, BLUR, BLUR_UNIFORMS, source, {0.0, 0.0}, {1920.0, 1080.0}, target, temp, damage, 24.0f, 0.5f, 4);
+
+    EXPECT_EQ(gl.counts.draws, 2 * 7);
+    for (const auto& draw : gl.draws)
+        EXPECT(intersect(draw.rect, {0, 0, 960, 540}) == draw.rect);
+}
+
+static void testStochasticIsOnePass() {
+    const auto   source  = buffer(1, 1920, 1080);
+    const auto   target  = buffer(2, 480, 270);
+    const auto   history = buffer(3, 480, 270);
+    const Region whole   = {{0, 0, 480, 270}};
+
+    CRecordingContext gl;
+    const uint64_t    pixels = GlassPasses::stochastic(gl, STOCHASTIC, STOCHASTIC_UNIFORMS, source, {0.0, 0.0}, {1920.0, 1080.0}, target, history,
+                                                       whole, {0.0, 0.0}, 0.8f, {6.0, 6.0}, 7);
+
+    EXPECT_EQ(gl.counts.draws, 1);
+    EXPECT_EQ(pixels, 480 * 270);
+    EXPECT_EQ(gl.counts.textureBinds, 2);
+    EXPECT_EQ(gl.counts.programs, 1);
+    EXPECT_EQ(gl.counts.uniforms, 8);
+}
+
+// ── Copies ───────────────────────────────────────────────────────────────────
+
+static void testSampleCopyStaysInSource() {
+    const auto   source = buffer(1, 1920, 1080);
+    const auto   target = buffer(2, 480, 270);
+    const Region damage = {{0, 0, 100, 100}, {300, 40, 480, 270}};
+
+    // Half resolution, hanging off the left and bottom edges
+    CRecordingContext gl;
+    const uint64_t    pixels = GlassPasses::sampleCopy(gl, source, {-100.0, 900.0}, {960.0, 540.0}, target, damage);
+
+    EXPECT_EQ(gl.counts.blits, 2);
+    EXPECT_EQ(pixels, area(damage[0]) + area(damage[1]));
+    EXPECT_EQ(gl.counts.draws, 0);
+    EXPECT_EQ(gl.counts.stallProne, 0);
+
+    // 100 source pixels cut on the left, 360 at the bottom: 50 and 180 target pixels
+    for (const auto& blit : gl.blits) {
+        EXPECT_EQ(blit.readFramebuffer, source.framebuffer);
+        EXPECT_EQ(blit.drawFramebuffer, target.framebuffer);
+        EXPECT_EQ(blit.filter, GL_LINEAR);
+        EXPECT(blit.source == SRect({0, 900, 860, 1080}));
+        EXPECT(intersect(blit.rect, {50, 0, 480, 90}) == blit.rect);
+    }
+}
+
+static void testCopyShiftedIsOneToOne() {
+    const auto   cache  = buffer(1, 960, 540);
+    const auto   target = buffer(2, 480, 270);
+    const Region damage = {{0, 0, 24, 24}, {200, 100, 260, 130}};
+
+    CRecordingContext gl;
+    const uint64_t    pixels = GlassPasses::copyShifted(gl, cache, {200, 100}, target, damage);
+
+    EXPECT_EQ(gl.counts.blits, 2);
+    EXPECT_EQ(pixels, area(damage[0]) + area(damage[1]));
+    EXPECT_EQ(gl.counts.stallProne, 0);
+    for (size_t i = 0; i < gl.blits.size(); i++) {
+        EXPECT(gl.blits[i].rect == damage[i]);
+        EXPECT(gl.blits[i].source == SRect({200, 100, 680, 370}));
+        EXPECT_EQ(gl.blits[i].filter, GL_NEAREST);
+    }
+}
+
+// ── Backdrop probe ───────────────────────────────────────────────────────────
+
+static constexpr size_t PROBE_SLOTS          = 3;
+static constexpr size_t PROBE_READBACK_BYTES = 4 * 4 * 4 * sizeof(float);
+
+// CBackdropProbe's ring of readbacks, polled then captured once per frame
+struct SProbeRing {
+    std::array<GLuint, PROBE_SLOTS> buffers  = {21, 22, 23};
+    std::array<GLsync, PROBE_SLOTS> fences   = {};
+    size_t                          next     = 0;
+    uint64_t                        readings = 0;
+    Region                          whole    = {{0, 0, 64, 64}};
+
+    void frame(CRecordingContext& gl) {
+        for (size_t i = 0; i < PROBE_SLOTS; i++) {
+            const size_t slot = (next + i) % PROBE_SLOTS;
+            if (fences[slot] && !GlassPasses::collectReadback(gl, fences[slot], buffers[slot], PROBE_READBACK_BYTES, [&](const float*) { readings++; }))
+                break;
+        }
+
+        // Every slot in flight: skip this capture
+        if (fences[next])
+            return;
+
+        const GlassPasses::SProbeTarget target = {30, 31, 32, 64, 4, buffers[next]};
+        fences[next] = GlassPasses::measure(gl, STATS, STATS_UNIFORMS, buffer(1, 1920, 1080), {100.0, 100.0, 800.0, 600.0}, target, whole);
+        next         = (next + 1) % PROBE_SLOTS;
+    }
+};
+
+static void testProbeNeverWaits() {
+    CRecordingContext gl;
+    SProbeRing        probe;
+
+    // The GPU lands the readbacks every fourth frame: the ring fills, skips
+    // a capture, then collects all three at once
+    for (int frame = 0; frame < 12; frame++) {
+        probe.frame(gl);
+        if (frame % 4 == 3)
+            gl.signalFences();
+    }
+
+    EXPECT_EQ(gl.counts.stallProne, 0);
+    EXPECT_EQ(gl.counts.readbacks, 9);
+    EXPECT_EQ(gl.counts.fences, 9);
+    EXPECT_EQ(gl.counts.mipmaps, 9);
+    EXPECT_EQ(gl.counts.maps, 6);
+    EXPECT_EQ(probe.readings, 6);
+    EXPECT_EQ(gl.liveFences(), 3);
+    EXPECT_EQ(gl.counts.draws, 9);
+    EXPECT_EQ(gl.counts.pixels, 9 * 64 * 64);
+
+    // The recording does catch a map that would wait on the readback
+    const GlassPasses::SProbeTarget target = {30, 31, 32, 64, 4, 21};
+    const Region                    whole  = {{0, 0, 64, 64}};
+    CRecordingContext               eager;
+    GlassPasses::measure(eager, STATS, STATS_UNIFORMS, buffer(1, 1920, 1080), {0.0, 0.0, 1920.0, 1080.0}, target, whole);
+    eager.mapBuffer(21, PROBE_READBACK_BYTES);
+    EXPECT_EQ(eager.counts.stallProne, 1);
+}
+
+// ── Composite ────────────────────────────────────────────────────────────────
+
+static void testCompositeCoversBoxOnce() {
+    const SRect  box    = {100, 100, 900, 700};
+    const Region damage = {{0, 0, 1920, 1080}};
+
+    // Bezel ring and interior: five disjoint pieces, two programs
+    {
+        CRecordingContext gl;
+        const uint64_t    pixels = GlassPasses::composite(gl, GLASS, GLASS_UNIFORMS, INTERIOR, INTERIOR_UNIFORMS, compositeOver(box, 24.0), damage);
+
+        EXPECT_EQ(pixels, area(box));
+        EXPECT_EQ(gl.counts.draws, 5);
+        EXPECT_EQ(gl.counts.programs, 2);
+        EXPECT_EQ(gl.counts.textureBinds, 3);
+        EXPECT_EQ(gl.counts.uniforms, GLASS_UPLOADS + INTERIOR_UPLOADS);
+
+        uint64_t interior = 0;
+        for (const auto& draw : gl.draws) {
+            EXPECT_EQ(draw.framebuffer, MONITOR_FRAMEBUFFER);
+            if (draw.program == INTERIOR.id)
+                interior += area(draw.rect);
+        }
+        EXPECT_EQ(interior, (800 - 48) * (600 - 48));
+    }
+
+    // No inset: the bezel shader covers it all
+    {
+        CRecordingContext gl;
+        const uint64_t    pixels = GlassPasses::composite(gl, GLASS, GLASS_UNIFORMS, INTERIOR, INTERIOR_UNIFORMS, compositeOver(box, 0.0), damage);
+
+        EXPECT_EQ(pixels, area(box));
+        EXPECT_EQ(gl.counts.draws, 1);
+        EXPECT_EQ(gl.counts.programs, 1);
+        EXPECT_EQ(gl.counts.uniforms, GLASS_UPLOADS);
+    }
+}
+
+static void testCompositeOnlyDrawsDamage() {
+    const SRect  box    = {100, 100, 900, 700};
+    const Region damage = {{50, 50, 150, 150}, {400, 300, 600, 400}, {880, 680, 1000, 800}, {1200, 0, 1300, 100}};
+
+    uint64_t expected = 0;
+    for (const auto& rect : damage)
+        expected += area(intersect(rect, box));
+
+    CRecordingContext gl;
+    const uint64_t    pixels = GlassPasses::composite(gl, GLASS, GLASS_UNIFORMS, INTERIOR, INTERIOR_UNIFORMS, compositeOver(box, 24.0), damage);
+
+    EXPECT_EQ(pixels, expected);
+    EXPECT(gl.counts.draws <= 5 * damage.size());
+    for (const auto& draw : gl.draws)
+        EXPECT(intersect(draw.rect, box) == draw.rect);
+}
+
+// ── Layouts ──────────────────────────────────────────────────────────────────
+
+// One frame of N tiled glass windows on a 1920×1080 monitor, under k damage
+// rects, the way the decoration drives the passes: each window blurs its
+// padded box at half resolution over the damage reaching it, then composites.
+struct SLayoutFrame {
+    SCounts  counts;
+    uint64_t compositePixels = 0;
+    uint64_t damagedWindows  = 0; // Σ over windows of the damage rects reaching it
+};
+
+static constexpr int LAYOUT_ITERATIONS = 3;
+static constexpr int LAYOUT_PADDING    = 40;
+
+static std::vector<SRect> tiledWindows(int count) {
+    const int          columns = static_cast<int>(std::ceil(std::sqrt(count)));
+    const int          rows    = (count + columns - 1) / columns;
+    std::vector<SRect> windows;
+    for (int i = 0; i < count; i++) {
+        const int column = i % columns, row = i / columns;
+        windows.push_back({1920 * column / columns + 4, 1080 * row / rows + 4, 1920 * (column + 1) / columns - 4, 1080 * (row + 1) / rows - 4});
+    }
+    return windows;
+}
+
+// k disjoint 24×24 rects spread over the monitor
+static Region scatteredDamage(int count) {
+    Region   damage;
+    uint32_t seed = 12345;
+    for (int i = 0; i < count; i++) {
+        seed           = seed * 1664525u + 1013904223u;
+        const int cell = static_cast<int>(seed >> 8) % (80 * 45);
+        const int x = cell % 80 * 24, y = cell / 80 * 24;
+        const bool taken = std::ranges::any_of(damage, [&](const SRect& rect) { return rect.x1 == x && rect.y1 == y; });
+        if (taken) {
+            i--;
+            continue;
+        }
+        damage.push_back({x, y, x + 24, y + 24});
+    }
+    return damage;
+}
+
+// What one window's passes draw with, built once like the decoration's regions
+struct SWindowPass {
+    SRect                   padded;
+    Region                  sampleDamage; // sample pixels, rounded out
+    GlassPasses::SBuffer    target, temp;
+    GlassPasses::SComposite composite;
+};
+
+static std::vector<SWindowPass> layoutPasses(const std::vector<SRect>& windows, const Region& damage) {
+    const float              scale = 0.5f;
+    std::vector<SWindowPass> passes;
+
+    for (const auto& window : windows) {
+        SWindowPass pass;
+        pass.padded = {window.x1 - LAYOUT_PADDING, window.y1 - LAYOUT_PADDING, window.x2 + LAYOUT_PADDING, window.y2 + LAYOUT_PADDING};
+
+        for (const auto& rect : damage) {
+            const SRect reached = intersect(rect, pass.padded);
+            if (empty(reached))
+                continue;
+            pass.sampleDamage.push_back({static_cast<int>(std::floor((reached.x1 - pass.padded.x1) * scale)),
+                                         static_cast<int>(std::floor((reached.y1 - pass.padded.y1) * scale)),
+                                         static_cast<int>(std::ceil((reached.x2 - pass.padded.x1) * scale)),
+                                         static_cast<int>(std::ceil((reached.y2 - pass.padded.y1) * scale))});
+        }
+
+        const int width  = static_cast<int>(std::ceil((pass.padded.x2 - pass.padded.x1) * scale));
+        const int height = static_cast<int>(std::ceil((pass.padded.y2 - pass.padded.y1) * scale));
+        pass.target      = buffer(2, width, height);
+        pass.temp        = buffer(3, width, height);
+        pass.composite   = compositeOver(window, 24.0);
+        passes.push_back(pass);
+    }
+    return passes;
+}
+
+static SLayoutFrame renderLayout(CRecordingContext& gl, const std::vector<SWindowPass>& passes, const Region& damage) {
+    const auto   source = buffer(1, 1920, 1080);
+    SLayoutFrame frame;
+    const auto   before = gl.counts;
+
+    for (const auto& pass : passes) {
+        if (pass.sampleDamage.empty())
+            continue;
+        frame.damagedWindows += pass.sampleDamage.size();
+
+        const auto& padded = pass.padded;
+        GlassPasses::render(gl, BLUR, BLUR_UNIFORMS, source, {static_cast<double>(padded.x1), static_cast<double>(padded.y1)},
+                            {static_cast<double>(padded.x2 - padded.x1), static_cast<double>(padded.y2 - padded.y1)}, pass.target, pass.temp,
+                            pass.sampleDamage, 12.0f, 0.5f, LAYOUT_ITERATIONS);
+
+        frame.compositePixels += GlassPasses::composite(gl, GLASS, GLASS_UNIFORMS, INTERIOR, INTERIOR_UNIFORMS, pass.composite, damage);
+    }
+
+    frame.counts = gl.counts - before;
+    return frame;
+}
+
+static void testLayoutBudgets() {
+    // Blur passes plus at most five composite pieces per damage rect reaching a window
+    constexpr uint64_t DRAWS_PER_RECT = 2 * LAYOUT_ITERATIONS - 1 + 5;
+
+    for (const int windowCount : {1, 4, 16, 64}) {
+        const auto windows = tiledWindows(windowCount);
+        for (const int rectCount : {1, 4, 16}) {
+            const Region damage = scatteredDamage(rectCount);
+
+            CRecordingContext  gl;
+            const SLayoutFrame frame = renderLayout(gl, layoutPasses(windows, damage), damage);
+
+            // Tiled windows are disjoint: each damaged pixel is composited once
+            uint64_t expected = 0;
+            for (const auto& window : windows)
+                for (const auto& rect : damage)
+                    expected += area(intersect(rect, window));
+
+            EXPECT_EQ(frame.compositePixels, expected);
+            EXPECT(frame.counts.draws <= DRAWS_PER_RECT * frame.damagedWindows);
+            EXPECT(frame.counts.draws <= DRAWS_PER_RECT * rectCount * windowCount);
+            for (const auto& draw : gl.draws)
+                EXPECT(!empty(draw.rect));
+
+            // Undamaged windows cost nothing; damaged ones a fixed setup
+            const uint64_t reached = std::ranges::count_if(windows, [&](const SRect& window) {
+                const SRect padded = {window.x1 - LAYOUT_PADDING, window.y1 - LAYOUT_PADDING, window.x2 + LAYOUT_PADDING, window.y2 + LAYOUT_PADDING};
+                return std::ranges::any_of(damage, [&](const SRect& rect) { return !empty(intersect(rect, padded)); });
+            });
+            EXPECT_EQ(frame.counts.programs, 3 * reached);
+            EXPECT_EQ(frame.counts.viewports, 2 * reached);
+            EXPECT_EQ(frame.counts.uniforms, (blurUploads(LAYOUT_ITERATIONS) + GLASS_UPLOADS + INTERIOR_UPLOADS) * reached);
+        }
+    }
+}
+
+// The rest of a steady frame's GL work: each window's sample half copied out
+// of the backdrop cache, half sampled unblurred, and the backdrop probed
+static void renderCopiesAndProbe(CRecordingContext& gl, const std::vector<SWindowPass>& passes, SProbeRing& probe) {
+    const auto source = buffer(1, 1920, 1080);
+    const auto cache  = buffer(4, 960, 540);
+
+    for (const auto& pass : passes) {
+        const auto& padded = pass.padded;
+        GlassPasses::copyShifted(gl, cache, {padded.x1 / 2, padded.y1 / 2}, pass.target, pass.sampleDamage);
+        GlassPasses::sampleCopy(gl, source, {static_cast<double>(padded.x1), static_cast<double>(padded.y1)},
+                                {static_cast<double>(padded.x2 - padded.x1), static_cast<double>(padded.y2 - padded.y1)}, pass.target, pass.sampleDamage);
+    }
+    probe.frame(gl);
+}
+
+static void testSteadyFrameNeverStalls() {
+    const auto   windows = tiledWindows(16);
+    const Region damage  = scatteredDamage(16);
+    const auto   passes  = layoutPasses(windows, damage);
+
+    uint64_t sampleRects = 0;
+    for (const auto& pass : passes)
+        sampleRects += pass.sampleDamage.size();
+
+    CRecordingContext gl;
+    SProbeRing        probe;
+    for (int frame = 0; frame < 8; frame++) {
+        const auto before = gl.counts;
+        renderLayout(gl, passes, damage);
+        renderCopiesAndProbe(gl, passes, probe);
+        if (frame % 2)
+            gl.signalFences();
+
+        const SCounts counts = gl.counts - before;
+        EXPECT_EQ(counts.stallProne, 0);
+        EXPECT_EQ(counts.blits, 2 * sampleRects);
+        EXPECT(counts.readbacks <= 1);
+    }
+}
+
+// Only the GlassPasses templates on the recording context: draw(), renderPass(),
+// Hyprland's render pass and pixman (which allocates with malloc) are not run
+static void testPassCodeAllocatesNothing() {
+    const auto   windows = tiledWindows(16);
+    const Region damage  = scatteredDamage(16);
+    const auto   passes  = layoutPasses(windows, damage);
+
+    // The first frame may size what the passes keep; later ones reuse it
+    CRecordingContext gl;
+    SProbeRing        probe;
+    renderLayout(gl, passes, damage);
+    renderCopiesAndProbe(gl, passes, probe);
+
+    for (int frame = 0; frame < 3; frame++) {
+        const uint64_t before = g_allocations;
+        renderLayout(gl, passes, damage);
+        renderCopiesAndProbe(gl, passes, probe);
+        gl.signalFences();
+        EXPECT_EQ(g_allocations - before, 0);
+    }
+}
+
+// ── Runner ───────────────────────────────────────────────────────────────────
+
+int main() {
+    const std::pair<const char*, std::function<void()>> tests[] = {
+        {"blur passes cover the grown damage", testBlurPassesCoverGrownDamage},
+        {"blur passes stay in the target", testBlurPassesStayInTarget},
+        {"stochastic blur is one pass", testStochasticIsOnePass},
+        {"sample copy stays in the source", testSampleCopyStaysInSource},
+        {"shifted copy is one to one", testCopyShiftedIsOneToOne},
+        {"backdrop probe never waits", testProbeNeverWaits},
+        {"composite covers the box once", testCompositeCoversBoxOnce},
+        {"composite only draws damage", testCompositeOnlyDrawsDamage},
+        {"layout budgets", testLayoutBudgets},
+        {"steady frame never stalls", testSteadyFrameNeverStalls},
+        {"pass code allocates nothing once warm", testPassCodeAllocatesNothing},
+    };
+
+    int failed = 0;
+    for (const auto& [name, test] : tests) {
+        const int before = g_failures;
+        test();
+        const bool passed = g_failures == before;
+        failed += !passed;
+        std::printf("%s %s\n", passed ? "PASS" : "FAIL", name);
+    }
+
+    std::printf("%d of %zu failed\n", failed, std::size(tests));
+    return failed == 0 ? 0 : 1;
+}
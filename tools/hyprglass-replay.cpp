@@ -0,0 +1,675 @@
+// Replays a frame-input capture (hyprctl hyprglass capture) offscreen and
+// prints the GPU time of every frame: the same sample paths over the same
+// rects, the same blur passes and the same composite, with the shaders, the
+// pass code (GlassPasses.hpp) and the baked textures of the plugin.
+//
+//   make tools && ./tools/hyprglass-replay [--csv] [--repeat N] <capture>
+//
+// Runs in a surfaceless EGL context, so a capture taken once can be replayed
+// against any driver or any change to the shaders. Where a pass carries no
+// backdrop, a generated pattern stands in for what was behind the window.
+// The capture is replayed N times (default 2); the first run warms up the
+// driver and allocates the buffers, and is only reported when N is 1.
+
+#include "../src/CaptureFormat.hpp"
+#include "../src/GlassPasses.hpp"
+#include "../src/Shaders.hpp"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES3/gl32.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Stands in for Hyprland's texture vertex shader: the quad in [0, 1]², the
+// projection uploaded by the plugin
+static const char* VERTEX_SHADER = R"GLSL(#version 300 es
+uniform mat3 proj;
+in vec2 pos;
+in vec2 texcoord;
+out vec2 v_texcoord;
+
+void main() {
+    gl_Position = vec4(proj * vec3(pos, 1.0), 1.0);
+    v_texcoord  = texcoord;
+})GLSL";
+
+static const char* PATTERN_SHADER = R"GLSL(#version 300 es
+precision highp float;
+in vec2 v_texcoord;
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+    vec2  cell  = floor(gl_FragCoord.xy / 48.0);
+    float check = mod(cell.x + cell.y, 2.0);
+    fragColor   = vec4(v_texcoord.x, v_texcoord.y, 0.35 + 0.4 * check, 1.0);
+})GLSL";
+
+// ── Capture ──────────────────────────────────────────────────────────────────
+
+struct SReplayPass {
+    Capture::SPass              pass = {};
+    std::vector<Capture::SRect> damage;
+    std::vector<Capture::SRect> blurred;
+    std::vector<Capture::SRect> cached;
+    std::vector<uint8_t>        backdrop;
+};
+
+struct SReplayFrame {
+    std::vector<SReplayPass> passes;
+    uint64_t                 timestampNs = 0;
+    int64_t                  monitorId   = -1;
+};
+
+static bool loadCapture(const char* path, std::vector<SReplayFrame>& frames) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "cannot open %s\n", path);
+        return false;
+    }
+    const std::vector<char> bytes{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+
+    size_t offset = 0;
+    auto   read   = [&](void* out, size_t size) {
+        if (offset + size > bytes.size())
+            return false;
+        std::memcpy(out, bytes.data() + offset, size);
+        offset += size;
+        return true;
+    };
+    auto readRects = [&](std::vector<Capture::SRect>& rects, uint32_t count) {
+        rects.resize(count);
+        return read(rects.data(), sizeof(Capture::SRect) * count);
+    };
+
+    Capture::SFileHeader header = {};
+    if (!read(&header, sizeof(header)) || header.magic != Capture::MAGIC || header.version != Capture::VERSION ||
+        header.passSize != sizeof(Capture::SPass)) {
+        std::fprintf(stderr, "%s: not a capture of this version of hyprglass\n", path);
+        return false;
+    }
+
+    SReplayFrame           frame;
+    Capture::SRecordHeader record = {};
+    while (read(&record, sizeof(record))) {
+        // A capture that is still being written ends with a partial record
+        const size_t end = offset + record.bytes;
+        if (end > bytes.size())
+            break;
+
+        if (record.type == Capture::RECORD_PASS && record.bytes >= sizeof(Capture::SPass)) {
+            SReplayPass replay;
+            read(&replay.pass, sizeof(replay.pass));
+
+            const auto&  pass     = replay.pass;
+            const size_t expected = sizeof(pass) + sizeof(Capture::SRect) * (static_cast<size_t>(pass.damageRects) + pass.blurredRects + pass.cachedRects) +
+                static_cast<size_t>(pass.backdropWidth) * pass.backdropHeight * 4;
+            if (expected == record.bytes) {
+                readRects(replay.damage, pass.damageRects);
+                readRects(replay.blurred, pass.blurredRects);
+                readRects(replay.cached, pass.cachedRects);
+                replay.backdrop.resize(static_cast<size_t>(pass.backdropWidth) * pass.backdropHeight * 4);
+                read(replay.backdrop.data(), replay.backdrop.size());
+                frame.passes.push_back(std::move(replay));
+            }
+        } else if (record.type == Capture::RECORD_FRAME_END && record.bytes == sizeof(Capture::SFrameEnd)) {
+            Capture::SFrameEnd frameEnd = {};
+            read(&frameEnd, sizeof(frameEnd));
+            frame.timestampNs = frameEnd.timestampNs;
+            frame.monitorId   = frameEnd.monitorId;
+            frames.push_back(std::move(frame));
+            frame = {};
+        }
+
+        offset = end;
+    }
+
+    return true;
+}
+
+// ── GL ───────────────────────────────────────────────────────────────────────
+
+struct SFramebuffer {
+    GLuint fbo     = 0;
+    GLuint texture = 0;
+    int    width   = 0;
+    int    height  = 0;
+
+    [[nodiscard]] GlassPasses::SBuffer buffer() const {
+        return {fbo, texture, width, height};
+    }
+
+    // RGBA8, like the plugin's buffers; no-op at the same size
+    void alloc(int w, int h) {
+        if (fbo && w == width && h == height)
+            return;
+
+        if (!fbo) {
+            glGenFramebuffers(1, &fbo);
+            glGenTextures(1, &texture);
+        }
+        width  = w;
+        height = h;
+
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+    }
+};
+
+// The uniforms Hyprland's texture shader setup covers in the plugin
+struct SProgram {
+    GLuint id   = 0;
+    GLint  proj = -1;
+    GLint  tex  = -1;
+};
+
+static bool compileProgram(SProgram& program, const char* name, const char* fragment) {
+    // Sources in Shaders.hpp open with a newline before #version
+    while (*fragment == '\n')
+        fragment++;
+
+    auto compile = [name](GLenum type, const char* source) {
+        const GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+
+        GLint status = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if (!status) {
+            char log[4096] = {};
+            glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            std::fprintf(stderr, "%s: %s\n", name, log);
+        }
+        return shader;
+    };
+
+    program.id = glCreateProgram();
+    glAttachShader(program.id, compile(GL_VERTEX_SHADER, VERTEX_SHADER));
+    glAttachShader(program.id, compile(GL_FRAGMENT_SHADER, fragment));
+    glBindAttribLocation(program.id, 0, "pos");
+    glBindAttribLocation(program.id, 1, "texcoord");
+    glLinkProgram(program.id);
+
+    GLint status = 0;
+    glGetProgramiv(program.id, GL_LINK_STATUS, &status);
+    if (!status) {
+        std::fprintf(stderr, "%s: link failed\n", name);
+        return false;
+    }
+
+    program.proj = glGetUniformLocation(program.id, "proj");
+    program.tex  = glGetUniformLocation(program.id, "tex");
+    return true;
+}
+
+static bool createContext() {
+    const auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    if (!getPlatformDisplay)
+        return false;
+
+    const EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr) || !eglBindAPI(EGL_OPENGL_ES_API))
+        return false;
+
+    const EGLint     attributes[] = {EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 2, EGL_NONE};
+    const EGLContext context      = eglCreateContext(display, EGL_NO_CONFIG_KHR, EGL_NO_CONTEXT, attributes);
+    return context != EGL_NO_CONTEXT && eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
+}
+
+// ── Replay ───────────────────────────────────────────────────────────────────
+
+using Rects = std::vector<Capture::SRect>;
+
+static uint64_t drawRect(int x1, int y1, int x2, int y2) {
+    if (x2 <= x1 || y2 <= y1)
+        return 0;
+    glScissor(x1, y1, x2 - x1, y2 - y1);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    return static_cast<uint64_t>(x2 - x1) * static_cast<uint64_t>(y2 - y1);
+}
+
+// GlassPasses context: straight to GL, one quad VAO for every program. The
+// rects of a region are drawn one by one, overlaps included, where the
+// plugin merges them first.
+class CReplayContext {
+  public:
+    GLuint vao = 0;
+
+    void useProgram(const SProgram& program, const std::array<float, 9>& projection) {
+        glUseProgram(program.id);
+        glUniformMatrix3fv(program.proj, 1, GL_FALSE, projection.data());
+        glUniform1i(program.tex, 0);
+        glBindVertexArray(vao);
+    }
+
+    void bindFramebuffer(GLenum target, GLuint framebuffer) {
+        glBindFramebuffer(target, framebuffer);
+    }
+
+    void bindTexture(GLuint unit, GLuint texture, GLenum target) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+    }
+
+    void setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+        glViewport(x, y, width, height);
+    }
+
+    void uniform1i(GLint location, GLint value) {
+        glUniform1i(location, value);
+    }
+
+    void uniform1f(GLint location, GLfloat value) {
+        glUniform1f(location, value);
+    }
+
+    void uniform2f(GLint location, GLfloat x, GLfloat y) {
+        glUniform2f(location, x, y);
+    }
+
+    void uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+        glUniform4f(location, x, y, z, w);
+    }
+
+    uint64_t drawGrown(const Rects& rects, double grow, int width, int height) {
+        const int by     = static_cast<int>(grow);
+        uint64_t  pixels = 0;
+        for (const auto& rect : rects)
+            pixels += drawRect(std::max(rect.x1 - by, 0), std::max(rect.y1 - by, 0), std::min(rect.x2 + by, width), std::min(rect.y2 + by, height));
+        return pixels;
+    }
+
+    uint64_t drawClipped(const Rects& rects, double x, double y, double width, double height) {
+        const int x1 = static_cast<int>(std::floor(x)), y1 = static_cast<int>(std::floor(y));
+        const int x2 = static_cast<int>(std::ceil(x + width)), y2 = static_cast<int>(std::ceil(y + height));
+
+        uint64_t pixels = 0;
+        for (const auto& rect : rects)
+            pixels += drawRect(std::max(x1, rect.x1), std::max(y1, rect.y1), std::min(x2, rect.x2), std::min(y2, rect.y2));
+        return pixels;
+    }
+
+    uint64_t blit(const Rects& rects, const std::array<int, 4>& source, const std::array<int, 4>& target, GLenum filter) {
+        uint64_t pixels = 0;
+        for (const auto& rect : rects) {
+            glScissor(rect.x1, rect.y1, rect.x2 - rect.x1, rect.y2 - rect.y1);
+            glBlitFramebuffer(source[0], source[1], source[2], source[3], target[0], target[1], target[2], target[3], GL_COLOR_BUFFER_BIT, filter);
+            pixels += static_cast<uint64_t>(rect.x2 - rect.x1) * static_cast<uint64_t>(rect.y2 - rect.y1);
+        }
+        return pixels;
+    }
+};
+
+struct SEdgeField {
+    GLuint texture       = 0;
+    float  cornerRadius  = -1.0f;
+    float  roundingPower = 0.0f;
+    float  bezelWidthPx  = 0.0f;
+    int    size          = 0;
+};
+
+struct SWindow {
+    SFramebuffer sample;
+    SEdgeField   edgeField;
+};
+
+class CReplay {
+  public:
+    bool init();
+
+    // GPU time of one pass, in milliseconds
+    double replayPass(const SReplayPass& replay);
+
+  private:
+    SProgram       m_glass, m_interior, m_blur, m_stochastic, m_pattern;
+    CReplayContext m_gl;
+
+    GlassPasses::SGlassUniforms          m_glassUniforms, m_interiorUniforms;
+    GlassPasses::SBlurUniforms           m_blurUniforms;
+    GlassPasses::SStochasticBlurUniforms m_stochasticUniforms;
+
+    std::unordered_map<int64_t, SFramebuffer> m_monitors; // the monitor framebuffers glass is drawn into
+    std::unordered_map<uint64_t, SWindow>     m_windows;
+    SFramebuffer                              m_temp;     // blurTempFramebuffer
+    SFramebuffer                              m_cache;    // stands in for the backdrop cache
+    SFramebuffer                              m_backdrop;
+
+    std::vector<std::pair<BakeKernels::STone, GLuint>> m_toneLuts;
+    std::vector<float>                                 m_texels;
+
+    SFramebuffer& monitorFramebuffer(const Capture::SPass& pass);
+    void          drawBackdrop(SFramebuffer& source, const SReplayPass& replay);
+    GLuint        edgeField(SEdgeField& field, const Capture::SPass& pass);
+    GLuint        toneLut(const BakeKernels::STone& tone);
+
+    void sampleCopy(SFramebuffer& source, SFramebuffer& sample, const SReplayPass& replay);
+    void sampleBlur(SFramebuffer& source, SFramebuffer& sample, const SReplayPass& replay);
+    void sampleStochastic(SFramebuffer& source, SFramebuffer& sample, const Capture::SPass& pass);
+    void composite(SFramebuffer& source, SWindow& window, const SReplayPass& replay);
+};
+
+bool CReplay::init() {
+    if (!compileProgram(m_glass, "liquidglass.frag", SHADERS.at("liquidglass.frag")) ||
+        !compileProgram(m_interior, "liquidglass_interior.frag", SHADERS.at("liquidglass_interior.frag")) ||
+        !compileProgram(m_blur, "gaussianblur.frag", SHADERS.at("gaussianblur.frag")) ||
+        !compileProgram(m_stochastic, "stochasticblur.frag", SHADERS.at("stochasticblur.frag")) ||
+        !compileProgram(m_pattern, "pattern", PATTERN_SHADER))
+        return false;
+
+    GlassPasses::queryUniforms(m_glass.id, m_glassUniforms);
+    GlassPasses::queryUniforms(m_interior.id, m_interiorUniforms);
+    GlassPasses::queryUniforms(m_blur.id, m_blurUniforms);
+    GlassPasses::queryUniforms(m_stochastic.id, m_stochasticUniforms);
+
+    // Position and texcoord of a triangle strip over [0, 1]²
+    static constexpr float QUAD[] = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+
+    GLuint vbo = 0;
+    glGenVertexArrays(1, &m_gl.vao);
+    glGenBuffers(1, &vbo);
+    glBindVertexArray(m_gl.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD), QUAD, GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glEnable(GL_SCISSOR_TEST);
+    glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+    return true;
+}
+
+SFramebuffer& CReplay::monitorFramebuffer(const Capture::SPass& pass) {
+    auto&     source = m_monitors[pass.monitorId];
+    const int width  = static_cast<int>(pass.framebufferWidth);
+    const int height = static_cast<int>(pass.framebufferHeight);
+    if (source.width == width && source.height == height)
+        return source;
+
+    source.alloc(width, height);
+    m_gl.useProgram(m_pattern, GlassPasses::FULLSCREEN_PROJECTION);
+    glViewport(0, 0, width, height);
+    drawRect(0, 0, width, height);
+    return source;
+}
+
+// The captured backdrop, stretched back over the padded rect
+void CReplay::drawBackdrop(SFramebuffer& source, const SReplayPass& replay) {
+    const auto& pass = replay.pass;
+    if (!pass.backdropWidth || !pass.backdropHeight)
+        return;
+
+    m_backdrop.alloc(static_cast<int>(pass.backdropWidth), static_cast<int>(pass.backdropHeight));
+    glBindTexture(GL_TEXTURE_2D, m_backdrop.texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_backdrop.width, m_backdrop.height, GL_RGBA, GL_UNSIGNED_BYTE, replay.backdrop.data());
+
+    const int x0 = static_cast<int>(pass.sampleOrigin[0]);
+    const int y0 = static_cast<int>(pass.sampleOrigin[1]);
+    glDisable(GL_SCISSOR_TEST);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_backdrop.fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, source.fbo);
+    glBlitFramebuffer(0, 0, m_backdrop.width, m_backdrop.height, x0, y0, x0 + static_cast<int>(pass.sampleExtent[0]),
+                      y0 + static_cast<int>(pass.sampleExtent[1]), GL_COLOR_BUFFER_BIT, GL_LINEAR);
+    glEnable(GL_SCISSOR_TEST);
+}
+
+GLuint CReplay::edgeField(SEdgeField& field, const Capture::SPass& pass) {
+    const int size = std::max(pass.edgeFieldSize, 1);
+    if (field.texture && field.cornerRadius == pass.edgeCornerRadius && field.roundingPower == pass.edgeRoundingPower &&
+        field.bezelWidthPx == pass.edgeBezelWidthPx && field.size == size)
+        return field.texture;
+
+    field.cornerRadius  = pass.edgeCornerRadius;
+    field.roundingPower = pass.edgeRoundingPower;
+    field.bezelWidthPx  = pass.edgeBezelWidthPx;
+    field.size          = size;
+    BakeKernels::edgeField(field.cornerRadius, field.roundingPower, field.bezelWidthPx, size, m_texels);
+
+    if (!field.texture)
+        glGenTextures(1, &field.texture);
+    glBindTexture(GL_TEXTURE_2D, field.texture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32F, size, size, 0, GL_RG, GL_FLOAT, m_texels.data());
+    return field.texture;
+}
+
+GLuint CReplay::toneLut(const BakeKernels::STone& tone) {
+    for (const auto& [key, texture] : m_toneLuts) {
+        if (key == tone)
+            return texture;
+    }
+
+    constexpr int SIZE = BakeKernels::TONE_LUT_SIZE;
+    BakeKernels::toneLut(tone, m_texels);
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_3D, texture);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA16F, SIZE, SIZE, SIZE, 0, GL_RGBA, GL_FLOAT, m_texels.data());
+
+    m_toneLuts.emplace_back(tone, texture);
+    return texture;
+}
+
+// CGlassDecoration::sampleBackground
+void CReplay::sampleCopy(SFramebuffer& source, SFramebuffer& sample, const SReplayPass& replay) {
+    const auto& pass = replay.pass;
+    GlassPasses::sampleCopy(m_gl, source.buffer(), {pass.sampleOrigin[0], pass.sampleOrigin[1]}, {pass.sampleExtent[0], pass.sampleExtent[1]},
+                            sample.buffer(), replay.blurred);
+}
+
+// BlurPasses::render, then the copy out of the backdrop cache
+void CReplay::sampleBlur(SFramebuffer& source, SFramebuffer& sample, const SReplayPass& replay) {
+    const auto& pass = replay.pass;
+
+    if (!replay.blurred.empty()) {
+        if (pass.blurIterations > 1)
+            m_temp.alloc(sample.width, sample.height);
+
+        GlassPasses::render(m_gl, m_blur, m_blurUniforms, source.buffer(), {pass.sampleOrigin[0], pass.sampleOrigin[1]},
+                            {pass.sampleExtent[0], pass.sampleExtent[1]}, sample.buffer(), m_temp.buffer(), replay.blurred, pass.blurRadius,
+                            pass.sampleScale, pass.blurIterations);
+    }
+
+    GlassPasses::copyShifted(m_gl, m_cache.buffer(), {0, 0}, sample.buffer(), replay.cached);
+}
+
+// BlurPasses::stochastic into the temp buffer, copied back over the history
+void CReplay::sampleStochastic(SFramebuffer& source, SFramebuffer& sample, const Capture::SPass& pass) {
+    m_temp.alloc(sample.width, sample.height);
+
+    const Rects whole = {{0, 0, sample.width, sample.height}};
+    GlassPasses::stochastic(m_gl, m_stochastic, m_stochasticUniforms, source.buffer(), {pass.sampleOrigin[0], pass.sampleOrigin[1]},
+                            {pass.sampleExtent[0], pass.sampleExtent[1]}, m_temp.buffer(), sample.buffer(), whole,
+                            {pass.historyOffset[0], pass.historyOffset[1]}, pass.historyWeight, {pass.stochasticSigma[0], pass.stochasticSigma[1]},
+                            pass.stochasticFrame);
+
+    GlassPasses::copyShifted(m_gl, m_temp.buffer(), {0, 0}, sample.buffer(), whole);
+}
+
+// CGlassDecoration::applyGlassEffect, over the framebuffer pixels the capture holds
+void CReplay::composite(SFramebuffer& source, SWindow& window, const SReplayPass& replay) {
+    const auto& pass = replay.pass;
+
+    GlassPasses::SComposite composite;
+    composite.framebuffer         = source.fbo;
+    composite.viewportWidth       = source.width;
+    composite.viewportHeight      = source.height;
+    composite.projection          = pass.projection;
+    composite.box                 = {pass.box[0], pass.box[1], pass.box[2], pass.box[3]};
+    composite.fullSize            = {pass.box[2], pass.box[3]};
+    composite.interiorInset       = pass.interiorInset;
+    composite.sample              = window.sample.texture;
+    composite.edgeField           = edgeField(window.edgeField, pass);
+    composite.edgeFieldSize       = std::max(pass.edgeFieldSize, 1);
+    composite.toneLut             = toneLut(pass.tone);
+    composite.uvPadding           = pass.uvPadding;
+    composite.fusedBlurRadius     = pass.fusedBlurRadius;
+    composite.fusedBlurDirection  = pass.fusedBlurDirection;
+    composite.refractionStrength  = pass.refractionStrength;
+    composite.chromaticAberration = pass.chromaticAberration;
+    composite.fresnelStrength     = pass.fresnelStrength;
+    composite.specularStrength    = pass.specularStrength;
+    composite.glassOpacity        = pass.glassOpacity;
+    composite.lensDistortion      = pass.lensDistortion;
+
+    // Hyprland's premultiplied blending, which the plugin draws under
+    glEnable(GL_BLEND);
+    GlassPasses::composite(m_gl, m_glass, m_glassUniforms, m_interior, m_interiorUniforms, composite, replay.damage);
+    glDisable(GL_BLEND);
+}
+
+double CReplay::replayPass(const SReplayPass& replay) {
+    const auto& pass   = replay.pass;
+    auto&       source = monitorFramebuffer(pass);
+    auto&       window = m_windows[pass.windowId];
+
+    // Scene setup, not timed: what was behind the window
+    drawBackdrop(source, replay);
+    if (pass.path == Capture::PATH_BLUR && !replay.cached.empty())
+        m_cache.alloc(std::max(m_cache.width, static_cast<int>(pass.sampleWidth)), std::max(m_cache.height, static_cast<int>(pass.sampleHeight)));
+    glBindVertexArray(m_gl.vao);
+    glFinish();
+
+    const auto start = std::chrono::steady_clock::now();
+
+    window.sample.alloc(static_cast<int>(pass.sampleWidth), static_cast<int>(pass.sampleHeight));
+    switch (pass.path) {
+        case Capture::PATH_COPY: sampleCopy(source, window.sample, replay); break;
+        case Capture::PATH_BLUR: sampleBlur(source, window.sample, replay); break;
+        case Capture::PATH_STOCHASTIC: sampleStochastic(source, window.sample, pass); break;
+        default: break;
+    }
+    composite(source, window, replay);
+
+    glFinish();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ── Report ───────────────────────────────────────────────────────────────────
+
+static void printHeader(bool csv) {
+    if (csv)
+        std::puts("frame,timestamp_ns,monitor,windows,reuse,copy,blur,stochastic,damage_rects,gpu_ms");
+    else
+        std::printf("%8s %4s %4s %6s %5s %5s %6s %7s %9s\n", "frame", "mon", "win", "reuse", "copy", "blur", "stoch", "damage", "gpu ms");
+}
+
+static void printFrame(size_t index, const SReplayFrame& frame, double ms, bool csv) {
+    std::array<int, 4> paths = {};
+    size_t             rects = 0;
+    for (const auto& replay : frame.passes) {
+        paths[std::min<size_t>(replay.pass.path, paths.size() - 1)]++;
+        rects += replay.damage.size();
+    }
+
+    if (csv)
+        std::printf("%zu,%llu,%lld,%zu,%d,%d,%d,%d,%zu,%.4f\n", index, static_cast<unsigned long long>(frame.timestampNs),
+                    static_cast<long long>(frame.monitorId), frame.passes.size(), paths[0], paths[1], paths[2], paths[3], rects, ms);
+    else
+        std::printf("%8zu %4lld %4zu %6d %5d %5d %6d %7zu %9.3f\n", index, static_cast<long long>(frame.monitorId), frame.passes.size(), paths[0],
+                    paths[1], paths[2], paths[3], rects, ms);
+}
+
+static void printSummary(std::vector<double> times, bool csv) {
+    if (times.empty())
+        return;
+
+    std::sort(times.begin(), times.end());
+    double sum = 0.0;
+    for (const double time : times)
+        sum += time;
+
+    auto percentile = [&times](double fraction) {
+        return times[std::min(times.size() - 1, static_cast<size_t>(fraction * static_cast<double>(times.size())))];
+    };
+
+    // Keeps --csv output a single table
+    std::fprintf(csv ? stderr : stdout, "%zu frames: mean %.3f ms, p50 %.3f ms, p95 %.3f ms, max %.3f ms\n", times.size(),
+                 sum / static_cast<double>(times.size()), percentile(0.5), percentile(0.95), times.back());
+}
+
+int main(int argc, char** argv) {
+    bool        csv    = false;
+    int         repeat = 2;
+    const char* path   = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--csv") == 0)
+            csv = true;
+        else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = std::max(1, std::atoi(argv[++i]));
+        else
+            path = argv[i];
+    }
+
+    if (!path) {
+        std::fprintf(stderr, "usage: %s [--csv] [--repeat N] <capture>\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<SReplayFrame> frames;
+    if (!loadCapture(path, frames))
+        return 1;
+    if (frames.empty()) {
+        std::fprintf(stderr, "%s: no complete frame\n", path);
+        return 1;
+    }
+
+    if (!createContext()) {
+        std::fprintf(stderr, "cannot create a surfaceless GLES 3.2 context\n");
+        return 1;
+    }
+
+    CReplay replay;
+    if (!replay.init())
+        return 1;
+
+    // Per frame, the mean over the reported runs
+    const int           reported = repeat > 1 ? repeat - 1 : 1;
+    std::vector<double> frameMs(frames.size(), 0.0);
+    for (int run = 0; run < repeat; run++) {
+        const bool report = repeat == 1 || run > 0;
+        for (size_t i = 0; i < frames.size(); i++) {
+            double ms = 0.0;
+            for (const auto& pass : frames[i].passes)
+                ms += replay.replayPass(pass);
+            if (report)
+                frameMs[i] += ms / reported;
+        }
+    }
+
+    printHeader(csv);
+    for (size_t i = 0; i < frames.size(); i++)
+        printFrame(i, frames[i], frameMs[i], csv);
+    printSummary(frameMs, csv);
+
+    return 0;
+}
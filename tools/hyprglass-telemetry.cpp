@@ -0,0 +1,121 @@
+// Tails the hyprglass telemetry ring (plugin:hyprglass:telemetry = 1) and
+// prints one line per published frame.
+//
+//   make tools && ./tools/hyprglass-telemetry [--csv]
+
+#include "../src/TelemetryFormat.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+static constexpr timespec POLL_INTERVAL = {0, 10'000'000};
+static constexpr timespec RETRY_INTERVAL = {1, 0};
+
+static const Telemetry::SSegment* mapSegment() {
+    const int fd = shm_open(Telemetry::segmentName().c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return nullptr;
+
+    void* mapping = mmap(nullptr, sizeof(Telemetry::SSegment), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return nullptr;
+
+    const auto* segment = static_cast<const Telemetry::SSegment*>(mapping);
+    if (segment->magic != Telemetry::MAGIC || segment->version != Telemetry::VERSION || segment->capacity != Telemetry::CAPACITY ||
+        segment->frameSize != sizeof(Telemetry::SFrame)) {
+        munmap(mapping, sizeof(Telemetry::SSegment));
+        return nullptr;
+    }
+
+    return segment;
+}
+
+// Seqlock read: false if the slot was being written or has been overwritten
+static bool readFrame(const Telemetry::SSegment& segment, uint64_t sequence, Telemetry::SFrame& frame) {
+    const auto&    slot   = segment.slots[sequence % Telemetry::CAPACITY];
+    const uint64_t before = slot.version.load(std::memory_order_acquire);
+    if (before & 1)
+        return false;
+
+    std::memcpy(&frame, &slot.frame, sizeof(frame));
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    return slot.version.load(std::memory_order_relaxed) == before && frame.sequence == sequence;
+}
+
+static void printHeader(bool csv) {
+    if (csv)
+        std::puts("sequence,timestamp_ns,monitor,windows,pixels_blurred,sample_reuses,fb_reallocs,gl_issued,gl_skipped,gpu_sequence,gpu_sample_ms,gpu_blur_ms,gpu_glass_ms");
+    else
+        std::printf("%10s %4s %4s %10s %6s %7s %7s %7s %9s %9s %9s\n", "frame", "mon", "win", "Mpx blur", "reuse", "realloc", "gl", "gl skip",
+                    "sample ms", "blur ms", "glass ms");
+}
+
+static void printFrame(const Telemetry::SFrame& frame, bool csv) {
+    const auto& gpu = frame.gpuMs;
+    if (csv) {
+        std::printf("%lu,%lu,%ld,%u,%lu,%u,%u,%u,%u,%lu,%.4f,%.4f,%.4f\n", frame.sequence, frame.timestampNs, frame.monitorId, frame.windowsDrawn,
+                    frame.pixelsBlurred, frame.sampleReuses, frame.framebufferReallocs, frame.glCallsIssued, frame.glCallsSkipped, frame.gpuSequence,
+                    gpu[Telemetry::STAGE_SAMPLE], gpu[Telemetry::STAGE_BLUR], gpu[Telemetry::STAGE_GLASS]);
+        return;
+    }
+
+    std::printf("%10lu %4ld %4u %10.3f %6u %7u %7u %7u", frame.sequence, frame.monitorId, frame.windowsDrawn, frame.pixelsBlurred / 1e6, frame.sampleReuses,
+                frame.framebufferReallocs, frame.glCallsIssued, frame.glCallsSkipped);
+    if (frame.gpuSequence)
+        std::printf(" %9.3f %9.3f %9.3f\n", gpu[Telemetry::STAGE_SAMPLE], gpu[Telemetry::STAGE_BLUR], gpu[Telemetry::STAGE_GLASS]);
+    else
+        std::printf(" %9s %9s %9s\n", "-", "-", "-");
+}
+
+int main(int argc, char** argv) {
+    const bool csv = argc > 1 && std::strcmp(argv[1], "--csv") == 0;
+    if (argc > 1 && !csv) {
+        std::fprintf(stderr, "usage: %s [--csv]\n", argv[0]);
+        return 1;
+    }
+
+    setvbuf(stdout, nullptr, _IOLBF, 0);
+    printHeader(csv);
+
+    const Telemetry::SSegment* segment = nullptr;
+    uint64_t                   next    = 0;
+
+    while (true) {
+        if (!segment) {
+            segment = mapSegment();
+            if (!segment) {
+                nanosleep(&RETRY_INTERVAL, nullptr);
+                continue;
+            }
+            // Start from the newest frame rather than replaying the history
+            next = segment->published.load(std::memory_order_acquire) + 1;
+        }
+
+        // The plugin cleared the magic: telemetry was disabled or the plugin unloaded
+        if (segment->magic != Telemetry::MAGIC) {
+            munmap(const_cast<Telemetry::SSegment*>(segment), sizeof(Telemetry::SSegment));
+            segment = nullptr;
+            continue;
+        }
+
+        const uint64_t published = segment->published.load(std::memory_order_acquire);
+        if (published >= next + Telemetry::CAPACITY) {
+            std::fprintf(stderr, "lost %lu frames\n", published - Telemetry::CAPACITY + 1 - next);
+            next = published - Telemetry::CAPACITY + 1;
+        }
+
+        for (; next <= published; next++) {
+            Telemetry::SFrame frame;
+            if (readFrame(*segment, next, frame))
+                printFrame(frame, csv);
+        }
+
+        nanosleep(&POLL_INTERVAL, nullptr);
+    }
+}